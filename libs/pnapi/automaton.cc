@@ -11,8 +11,9 @@
 #include "port.h"
 #include "util.h"
 
-#include <sstream>
-#include <ctime>
+#include <cstdio>
+#include <deque>
+#include <pthread.h>
 
 using std::cerr;
 using std::cout;
@@ -32,7 +33,8 @@ namespace pnapi
  * The result of the constructor is an emty automaton.
  */
 Automaton::Automaton() :
-  edgeLabels_(NULL), edgeTypes_(NULL), weights_(NULL), net_(NULL), hashTable_(NULL), stateCounter_(0)
+  edgeLabels_(NULL), edgeTypes_(NULL), firingRule_(NULL), net_(NULL),
+  stateCounter_(0)
 {
   /* do nothing */
 }
@@ -48,16 +50,23 @@ Automaton::Automaton() :
  * At last the DEPTH-FIRST-SEARCH is started and results in a fully
  * built automaton from a Petri Net.
  * 
+ * With more than one thread, the state space is explored in parallel
+ * (see parallelSearch()). The result is isomorphic to the one of the
+ * sequential search; with deterministic numbering, it is even identical.
+ *
+ * \param net            the Petri net
+ * \param threads        the number of threads exploring the state space
+ * \param deterministic  whether the states shall be numbered and the edges
+ *                       be created in the order of the sequential search
+ *
  * \bug What about unnormal nets?
  */
-Automaton::Automaton(PetriNet & net) :
+Automaton::Automaton(PetriNet & net, unsigned int threads, bool deterministic) :
   stateCounter_(0)
 {
   // initializing private variables
   net_ = new PetriNet(net);
   edgeTypes_ = new std::map<Transition *, Edge::Type>();
-  weights_ = new std::map<const Place *, unsigned int>();
-  hashTable_ = new std::vector<std::set<State *> >(HASH_SIZE);
   
   // normalizing the copied net and retrieving the edge labels
   edgeLabels_ = new std::map<Transition *, std::string>(net_->normalize());
@@ -99,30 +108,29 @@ Automaton::Automaton(PetriNet & net) :
     }
   }
   
-  // making a marking's hash value more random
-  srand(time(NULL));
-  
-  // setting place weights
-  PNAPI_FOREACH(p, net_->getPlaces())
-  {
-    (*weights_)[*p] = rand() % HASH_SIZE;
-  }
+  // compiling presets and effects of the transitions
+  firingRule_ = new FiringRule(*net_);
   
   // creating initial state
   State & start = createState(*new Marking(*net_));
   start.setInitial();
   
   // beginning to find follow-up states
-  dfs(start);
+  if (threads > 1)
+  {
+    parallelSearch(start, threads, deterministic);
+  }
+  else
+  {
+    dfs(start);
+  }
   
   delete edgeLabels_;
   edgeLabels_ = NULL;
   delete edgeTypes_;
   edgeTypes_ = NULL;
-  delete hashTable_;
-  hashTable_ = NULL;
-  delete weights_;
-  weights_ = NULL;
+  delete firingRule_;
+  firingRule_ = NULL;
 }
 
 
@@ -136,7 +144,7 @@ Automaton::Automaton(const Automaton & a) :
   input_(a.input_), output_(a.output_),
   synchronous_(a.synchronous_),
   edgeLabels_(NULL), edgeTypes_(NULL),
-  weights_(NULL), net_(NULL), hashTable_(NULL), stateCounter_(a.stateCounter_)
+  firingRule_(NULL), net_(NULL), stateCounter_(a.stateCounter_)
 {
   map<const Place *, const Place *> placeMap;
 
@@ -259,7 +267,7 @@ State & Automaton::createState(const unsigned int name)
  */
 State & Automaton::createState(Marking & m)
 {
-  State * s = new State(m, weights_, stateCounter_);
+  State * s = new State(m, stateCounter_);
   PNAPI_ASSERT(s != NULL);
   states_.push_back(s);
   return *s;
@@ -326,8 +334,7 @@ PetriNet Automaton::toStateMachine() const
   // caches for faster place search
   map<string, Place *> interfacePlaces;
 
-  Condition final;
-  final = false; // final places
+  std::vector<const formula::Formula *> final; // final places
 
   /* no comment */
 
@@ -352,11 +359,9 @@ PetriNet Automaton::toStateMachine() const
   // generate places from states
   for(unsigned int i = 0; i < states_.size(); ++i)
   {
-    std::stringstream ss;
-    std::string id;
-    ss << states_[i]->getName();
-    ss >> id;
-    Place * p = &(result.createPlace("p"+id));
+    char name[16];
+    sprintf(name, "p%u", states_[i]->getName());
+    Place * p = &(result.createPlace(name));
     state2place[states_[i]] = p;
     if (states_[i]->isInitial())
     {
@@ -369,7 +374,7 @@ PetriNet Automaton::toStateMachine() const
      */
     if(states_[i]->isFinal())
     {
-      final = (final.getFormula() || ((*p) == 1));
+      final.push_back(new formula::FormulaEqual(*p, 1));
     }
   }
 
@@ -391,7 +396,14 @@ PetriNet Automaton::toStateMachine() const
   }
 
   // generate final condition
-  result.getFinalCondition() = final.getFormula();
+  if (final.empty())
+  {
+    result.getFinalCondition() = false;
+  }
+  else
+  {
+    result.getFinalCondition() = formula::Disjunction(final);
+  }
   result.getFinalCondition().allOtherPlacesEmpty(result); // actually unneccassary
 
   return result;
@@ -506,91 +518,593 @@ const std::set<std::string> & Automaton::getSynchronousLabels() const
  * \brief depth-first-search in the unknown automaton
  * 
  * Special depth first search method for service automaton creation
- * from Petri net. It's a recursive method which takes a State (named
- * start) and then tries to find its successors.
+ * from Petri net. It takes a State (named start) and explores all states
+ * reachable from it. The search uses an explicit stack, so the depth of
+ * the state space is not limited by the call stack, and finds known
+ * states in an open addressing table, so successor states are only
+ * allocated if they are new.
  *
  * \param start first node
  */
 void Automaton::dfs(State & start)
 {
-  //cerr << "dfs on node " << start.name() << "..." << endl;
-  (*hashTable_)[start.getHashValue()].insert(&start);
+  const std::vector<Transition *> & transitions = firingRule_->getTransitions();
+  const Condition & finalCondition = net_->getFinalCondition();
 
-  // assuming that each state has a marking
-  Marking * m = start.getMarking();
-  PNAPI_ASSERT(m != NULL);
+  StateTable table;
+  // the states on the search stack and their next transition to be checked
+  std::vector<std::pair<State *, unsigned int> > stack;
+  Marking successor(*start.getMarking());
 
-  // final state
-  if(net_->getFinalCondition().isSatisfied(*m))
+  table.insert(start);
+  if (finalCondition.isSatisfied(*start.getMarking()))
   {
     start.setFinal();
   }
+  stack.push_back(std::make_pair(&start, 0u));
 
-  // iterate over all transitions to check if they can fire
-  PNAPI_FOREACH(t, net_->getTransitions())
+  while (!stack.empty())
   {
-    if (!(m->activates(**t)))
+    State & current = *stack.back().first;
+    const unsigned int i = stack.back().second++;
+
+    if (i == transitions.size())
+    {
+      stack.pop_back();
+      continue;
+    }
+
+    // assuming that each state has a marking
+    const Marking & m = *current.getMarking();
+    if (!firingRule_->activates(m, i))
       continue;
 
-    //cerr << "transition " << (*t)->getName() << " is activated..." << endl;
-    State & succ = createState(m->getSuccessor(**t));
+    successor = m;
+    firingRule_->fire(successor, i);
+    Transition * t = transitions[i];
 
-    //cerr << "created node " << j.name() << endl;
-    if (start == succ)
+    // self loops and known states only get an edge
+    State * known = table.find(successor, successor.getHashValue());
+    if (known != NULL)
     {
-      deleteState(succ);
-      createEdge(start, start, (*edgeLabels_)[*t], (*edgeTypes_)[*t]);
+      createEdge(current, *known, (*edgeLabels_)[t], (*edgeTypes_)[t]);
       continue;
     }
 
-    // collision detection
-    bool doubled = false;
+    State & succ = createState(*new Marking(successor));
+    table.insert(succ);
+    if (finalCondition.isSatisfied(successor))
+    {
+      succ.setFinal();
+    }
+    createEdge(current, succ, (*edgeLabels_)[t], (*edgeTypes_)[t]);
+
+    stack.push_back(std::make_pair(&succ, 0u));
+  }
+}
+
+
+/*!
+ * \brief a state found by the parallel search
+ */
+struct SearchNode
+{
+  /// the marking of the state
+  Marking * marking;
+  /// its hash value
+  unsigned int hash;
+  /// whether the marking satisfies the final condition
+  bool final;
+  /// the activated transitions (by number) and the successors under them
+  std::vector<std::pair<unsigned int, SearchNode *> > edges;
+  /// the state created for this node
+  State * state;
+};
+
+
+/*!
+ * \brief table of the nodes of the parallel search
+ *
+ * The table is split into shards by the high bits of the hash value. Each
+ * shard is an open addressing table like StateTable with its own lock, so
+ * threads only wait for each other if they look up markings of the same
+ * shard at the same time.
+ */
+class SearchNodeTable
+{
+private: /* private types */
+  /// a part of the table
+  struct Shard
+  {
+    pthread_mutex_t mutex;
+    std::vector<SearchNode *> slots;
+    size_t entries;
+  };
+
+  /// the number of shards (a power of two)
+  static const unsigned int SHARDS = 64;
+
+  /// the shards
+  Shard shards_[SHARDS];
+
+public: /* public methods */
+  /// constructor
+  SearchNodeTable()
+  {
+    for (unsigned int i = 0; i < SHARDS; ++i)
+    {
+      pthread_mutex_init(&shards_[i].mutex, NULL);
+      shards_[i].slots.assign(64, NULL);
+      shards_[i].entries = 0;
+    }
+  }
+
+  /// destructor
+  ~SearchNodeTable()
+  {
+    for (unsigned int i = 0; i < SHARDS; ++i)
+    {
+      pthread_mutex_destroy(&shards_[i].mutex);
+    }
+  }
+
+  /*!
+   * \brief finds the node with the given marking or inserts a new one
+   *
+   * \param m         the marking, copied for a new node
+   * \param hash      its hash value
+   * \param inserted  set to whether a new node was inserted
+   */
+  SearchNode * findOrInsert(const Marking & m, unsigned int hash, bool & inserted)
+  {
+    Shard & shard = shards_[hash >> 26];
+    pthread_mutex_lock(&shard.mutex);
+
+    size_t mask = shard.slots.size() - 1;
+    size_t i = hash & mask;
+    for (; shard.slots[i] != NULL; i = (i + 1) & mask)
+    {
+      if ((shard.slots[i]->hash == hash) && (*shard.slots[i]->marking == m))
+      {
+        SearchNode * node = shard.slots[i];
+        pthread_mutex_unlock(&shard.mutex);
+        inserted = false;
+        return node;
+      }
+    }
+
+    SearchNode * node = new SearchNode();
+    node->marking = new Marking(m);
+    node->hash = hash;
+    node->final = false;
+    node->state = NULL;
+    insert(shard, node);
 
-    PNAPI_FOREACH(s, (*hashTable_)[succ.getHashValue()])
+    pthread_mutex_unlock(&shard.mutex);
+    inserted = true;
+    return node;
+  }
+
+  /// inserts a node without looking for its marking
+  void insert(SearchNode * node)
+  {
+    Shard & shard = shards_[node->hash >> 26];
+    pthread_mutex_lock(&shard.mutex);
+    insert(shard, node);
+    pthread_mutex_unlock(&shard.mutex);
+  }
+
+private: /* private methods */
+  /// inserts a node into a locked shard, doubling it if it is half full
+  void insert(Shard & shard, SearchNode * node)
+  {
+    if (2 * (shard.entries + 1) > shard.slots.size())
     {
-      if (**s == succ)
+      std::vector<SearchNode *> old(2 * shard.slots.size(), NULL);
+      old.swap(shard.slots);
+      PNAPI_FOREACH(it, old)
       {
-        doubled = true;
-        createEdge(start, **s, (*edgeLabels_)[*t], (*edgeTypes_)[*t]);
-        break;
+        if (*it != NULL)
+        {
+          place(shard, *it);
+        }
       }
     }
+    place(shard, node);
+    ++shard.entries;
+  }
+
+  /// puts a node into the first free slot of its probe sequence
+  void place(Shard & shard, SearchNode * node)
+  {
+    const size_t mask = shard.slots.size() - 1;
+    size_t i = node->hash & mask;
+    while (shard.slots[i] != NULL)
+    {
+      i = (i + 1) & mask;
+    }
+    shard.slots[i] = node;
+  }
+};
+
+
+/*!
+ * \brief the frontier of one thread of the parallel search
+ *
+ * The owner pushes and pops nodes at the back, so each thread searches
+ * depth-first; idle threads steal nodes from the front.
+ */
+class SearchQueue
+{
+private: /* private variables */
+  pthread_mutex_t mutex_;
+  std::deque<SearchNode *> nodes_;
+
+public: /* public methods */
+  SearchQueue() { pthread_mutex_init(&mutex_, NULL); }
+  ~SearchQueue() { pthread_mutex_destroy(&mutex_); }
+
+  /// adds a node at the back
+  void push(SearchNode * node)
+  {
+    pthread_mutex_lock(&mutex_);
+    nodes_.push_back(node);
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  /// removes a node from the back or the front
+  bool pop(SearchNode * & node, bool steal)
+  {
+    pthread_mutex_lock(&mutex_);
+    const bool result = !nodes_.empty();
+    if (result)
+    {
+      node = steal ? nodes_.front() : nodes_.back();
+      if (steal)
+      {
+        nodes_.pop_front();
+      }
+      else
+      {
+        nodes_.pop_back();
+      }
+    }
+    pthread_mutex_unlock(&mutex_);
+    return result;
+  }
+};
+
+
+/*!
+ * \brief the data shared by the threads of the parallel search
+ */
+struct ParallelSearch
+{
+  /// firing rule of the net
+  const FiringRule * firingRule;
+  /// final condition of the net
+  const Condition * finalCondition;
+  /// the nodes found so far
+  SearchNodeTable table;
+  /// the frontier of each thread
+  std::vector<SearchQueue *> queues;
+  /// the nodes each thread has found, in the order of their discovery
+  std::vector<std::vector<SearchNode *> > found;
+  /// protects the counters below
+  pthread_mutex_t mutex;
+  /// signaled when nodes were queued or the search is over
+  pthread_cond_t wakeup;
+  /// the number of nodes found but not yet expanded
+  size_t outstanding;
+  /// the number of expansions which queued new nodes so far
+  size_t published;
+  /// the number of threads waiting for nodes
+  unsigned int idle;
+};
+
+
+/// the arguments of a thread of the parallel search
+struct SearchThread
+{
+  ParallelSearch * search;
+  unsigned int id;
+};
+
+
+/*!
+ * \brief a thread of the parallel search
+ *
+ * Expands nodes from its own queue and steals from the others if it runs
+ * dry. If no queue has a node, the thread waits until another thread
+ * queues new nodes. The search is over when no node is found but not yet
+ * expanded.
+ */
+static void * searchThread(void * argument)
+{
+  ParallelSearch & search = *static_cast<SearchThread *>(argument)->search;
+  const unsigned int id = static_cast<SearchThread *>(argument)->id;
+  const unsigned int threads = search.queues.size();
+  const unsigned int transitions = search.firingRule->getTransitions().size();
+  Marking successor;
+
+  while (true)
+  {
+    // nodes are queued before they are published, so a thread which saw
+    // no node in the queues misses no nodes published after this point
+    pthread_mutex_lock(&search.mutex);
+    const size_t published = search.published;
+    pthread_mutex_unlock(&search.mutex);
+
+    SearchNode * node = NULL;
+    bool gotNode = search.queues[id]->pop(node, false);
+    for (unsigned int k = 1; !gotNode && (k < threads); ++k)
+    {
+      gotNode = search.queues[(id + k) % threads]->pop(node, true);
+    }
 
-    if (doubled)
+    if (!gotNode)
     {
-      deleteState(succ);
+      pthread_mutex_lock(&search.mutex);
+      ++search.idle;
+      while ((search.published == published) && (search.outstanding > 0))
+      {
+        pthread_cond_wait(&search.wakeup, &search.mutex);
+      }
+      --search.idle;
+      const bool done = (search.outstanding == 0);
+      pthread_mutex_unlock(&search.mutex);
+      if (done)
+      {
+        break;
+      }
       continue;
     }
 
-    createEdge(start, succ, (*edgeLabels_)[*t], (*edgeTypes_)[*t]);
+    size_t newNodes = 0;
+    for (unsigned int i = 0; i < transitions; ++i)
+    {
+      if (!search.firingRule->activates(*node->marking, i))
+        continue;
+
+      successor = *node->marking;
+      search.firingRule->fire(successor, i);
 
-    dfs(succ);
+      bool inserted;
+      SearchNode * succ = search.table.findOrInsert(successor, successor.getHashValue(), inserted);
+      node->edges.push_back(std::make_pair(i, succ));
+
+      if (inserted)
+      {
+        succ->final = search.finalCondition->isSatisfied(*succ->marking);
+        search.found[id].push_back(succ);
+        search.queues[id]->push(succ);
+        ++newNodes;
+      }
+    }
+
+    // the new nodes are outstanding, the expanded one is not any more
+    pthread_mutex_lock(&search.mutex);
+    search.outstanding += newNodes;
+    --search.outstanding;
+    if (newNodes > 0)
+    {
+      ++search.published;
+    }
+    if ((search.idle > 0) && ((newNodes > 0) || (search.outstanding == 0)))
+    {
+      pthread_cond_broadcast(&search.wakeup);
+    }
+    pthread_mutex_unlock(&search.mutex);
   }
+
+  return NULL;
 }
 
 
 /*!
- * \brief deleting a state from the automaton
+ * \brief multi-threaded search in the unknown automaton
+ *
+ * The threads only find the states and their successors; states and
+ * edges of the automaton are created afterwards by the calling thread.
+ * With deterministic numbering, this is done in the order of dfs(), so
+ * the result is the same as with the sequential search. Otherwise, the
+ * states are numbered by thread and order of discovery.
+ *
+ * \param start          first node
+ * \param threads        the number of threads
+ * \param deterministic  whether to number the states like dfs()
  */
-void Automaton::deleteState(State & s)
+void Automaton::parallelSearch(State & start, unsigned int threads, bool deterministic)
 {
-  if (s.getPreset().empty() && s.getPostset().empty())
+  const std::vector<Transition *> & transitions = firingRule_->getTransitions();
+
+  ParallelSearch search;
+  search.firingRule = firingRule_;
+  search.finalCondition = &net_->getFinalCondition();
+  search.found.resize(threads);
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    search.queues.push_back(new SearchQueue());
+  }
+  pthread_mutex_init(&search.mutex, NULL);
+  pthread_cond_init(&search.wakeup, NULL);
+
+  // the start state already exists and keeps its marking
+  SearchNode * first = new SearchNode();
+  first->marking = start.getMarking();
+  first->hash = start.getMarking()->getHashValue();
+  first->final = search.finalCondition->isSatisfied(*first->marking);
+  first->state = &start;
+  search.table.insert(first);
+  search.queues[0]->push(first);
+  search.outstanding = 1;
+  search.published = 0;
+  search.idle = 0;
+
+  std::vector<pthread_t> handles(threads);
+  std::vector<SearchThread> arguments(threads);
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    arguments[i].search = &search;
+    arguments[i].id = i;
+    const int error = pthread_create(&handles[i], NULL, searchThread, &arguments[i]);
+    PNAPI_ASSERT(error == 0);
+  }
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    pthread_join(handles[i], NULL);
+  }
+
+  if (first->final)
+  {
+    start.setFinal();
+  }
+
+  if (deterministic)
+  {
+    // replay dfs() on the found nodes
+    std::vector<std::pair<SearchNode *, unsigned int> > stack;
+    stack.push_back(std::make_pair(first, 0u));
+    while (!stack.empty())
+    {
+      SearchNode & current = *stack.back().first;
+      const unsigned int e = stack.back().second++;
+      if (e == current.edges.size())
+      {
+        stack.pop_back();
+        continue;
+      }
+
+      SearchNode & succ = *current.edges[e].second;
+      Transition * t = transitions[current.edges[e].first];
+      if (succ.state == NULL)
+      {
+        succ.state = &createState(*succ.marking);
+        if (succ.final)
+        {
+          succ.state->setFinal();
+        }
+        createEdge(*current.state, *succ.state, (*edgeLabels_)[t], (*edgeTypes_)[t]);
+        stack.push_back(std::make_pair(&succ, 0u));
+      }
+      else
+      {
+        createEdge(*current.state, *succ.state, (*edgeLabels_)[t], (*edgeTypes_)[t]);
+      }
+    }
+  }
+  else
   {
-    if (states_[states_.size()-1] != &s)
+    std::vector<SearchNode *> nodes(1, first);
+    for (unsigned int i = 0; i < threads; ++i)
     {
-      for (unsigned int i = 0; i < states_.size()-2; i++)
+      PNAPI_FOREACH(n, search.found[i])
       {
-        if (states_[i] == &s)
+        (*n)->state = &createState(*(*n)->marking);
+        if ((*n)->final)
         {
-          states_[i] = states_[states_.size()-1];
-          break;
+          (*n)->state->setFinal();
         }
+        nodes.push_back(*n);
       }
     }
-    states_.pop_back();
+    PNAPI_FOREACH(n, nodes)
+    {
+      PNAPI_FOREACH(e, (*n)->edges)
+      {
+        Transition * t = transitions[e->first];
+        createEdge(*(*n)->state, *e->second->state, (*edgeLabels_)[t], (*edgeTypes_)[t]);
+      }
+    }
+  }
+
+  // the markings now belong to the states
+  delete first;
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    PNAPI_FOREACH(n, search.found[i])
+    {
+      delete *n;
+    }
+    delete search.queues[i];
+  }
+  pthread_cond_destroy(&search.wakeup);
+  pthread_mutex_destroy(&search.mutex);
+}
+
+
+/****************************************************************************
+ *** Class StateTable Function Definitions
+ ***************************************************************************/
 
-    delete (&s);
+/*!
+ * \brief constructor
+ */
+StateTable::StateTable() :
+  slots_(INITIAL_SIZE, NULL), entries_(0)
+{
+}
+
+
+/*!
+ * \brief finds the state with the given marking
+ *
+ * \param m     the marking
+ * \param hash  its hash value, see Marking::getHashValue()
+ *
+ * \return the state or NULL if there is none
+ */
+State * StateTable::find(const Marking & m, unsigned int hash) const
+{
+  const size_t mask = slots_.size() - 1;
+  for (size_t i = hash & mask; slots_[i] != NULL; i = (i + 1) & mask)
+  {
+    if ((slots_[i]->getHashValue() == hash) && (*slots_[i]->getMarking() == m))
+    {
+      return slots_[i];
+    }
+  }
+  return NULL;
+}
+
+
+/*!
+ * \brief inserts a state which is not yet in the table
+ *
+ * The table doubles its size whenever it becomes half full.
+ */
+void StateTable::insert(State & s)
+{
+  if (2 * (entries_ + 1) > slots_.size())
+  {
+    std::vector<State *> old(2 * slots_.size(), NULL);
+    old.swap(slots_);
+    PNAPI_FOREACH(it, old)
+    {
+      if (*it != NULL)
+      {
+        place(**it);
+      }
+    }
+  }
+
+  place(s);
+  ++entries_;
+}
+
+
+/*!
+ * \brief puts a state into the first free slot of its probe sequence
+ */
+void StateTable::place(State & s)
+{
+  const size_t mask = slots_.size() - 1;
+  size_t i = s.getHashValue() & mask;
+  while (slots_[i] != NULL)
+  {
+    i = (i + 1) & mask;
   }
+  slots_[i] = &s;
 }
 
 
@@ -16,9 +16,43 @@ namespace pnapi
 {
 
 /// forward declaration
+class FiringRule;
 class Marking;
 class PetriNet;
 
+/*!
+ * \brief   Table of the states of an automaton, keyed by their markings
+ *
+ * Open addressing with linear probing over a power-of-two sized array,
+ * which doubles whenever it becomes half full. The slots are indexed by
+ * the low bits of Marking::getHashValue().
+ */
+class StateTable
+{
+private: /* private constants */
+  /// initial number of slots
+  static const size_t INITIAL_SIZE = 1024;
+
+private: /* private variables */
+  /// the slots, NULL if free
+  std::vector<State *> slots_;
+  /// the number of states in the table
+  size_t entries_;
+
+public: /* public methods */
+  /// constructor
+  StateTable();
+  /// finds the state with the given marking and hash value
+  State * find(const Marking &, unsigned int) const;
+  /// inserts a state which is not yet in the table
+  void insert(State &);
+
+private: /* private methods */
+  /// puts a state into the first free slot of its probe sequence
+  void place(State &);
+};
+
+
 /*!
  * \brief Service Automaton class
  */
@@ -29,10 +63,6 @@ class Automaton
   friend std::ostream & io::__stat::output(std::ostream &, const Automaton &);
   friend std::ostream & io::__dot::output(std::ostream &, const Automaton &);
 
-public: /* public constants */
-  /// hash table size
-  static const unsigned int HASH_SIZE = 65535;
-  
 private: /* private variables */
   /// vector of states
   std::vector<State *> states_;
@@ -50,13 +80,11 @@ private: /* private variables */
   std::map<Transition *, std::string> * edgeLabels_;
   /// mapping from transitions to their types [optional]
   std::map<Transition *, Edge::Type> * edgeTypes_;
-  /// mapping from places to their weight [optional]
-  std::map<const Place *, unsigned int> * weights_;
+  /// firing rule of the underlying Petri net [optional]
+  FiringRule * firingRule_;
 
   /// underlying Petri net [optional]
   PetriNet * net_;
-  /// the hash table [optional] needed by PetriNet => Automaton
-  std::vector<std::set<State *> > * hashTable_;
   /// state counter
   unsigned int stateCounter_;
 
@@ -68,7 +96,7 @@ public: /* public methods */
   /// standard constructor
   Automaton();
   /// constructor generating automaton from Petri net
-  Automaton(PetriNet &);
+  Automaton(PetriNet &, unsigned int = 1, bool = false);
   /// standard copy constructor
   Automaton(const Automaton &);
   /// assignment operator
@@ -130,10 +158,10 @@ public: /* public methods */
   //@}
   
 private: /* private methods */
-  /// deleting a state from the automaton
-  void deleteState(State &);
   /// depth-first-search in the unknown automaton
   void dfs(State &);
+  /// multi-threaded search in the unknown automaton
+  void parallelSearch(State &, unsigned int, bool);
 };
 
 } /* namespace pnapi */
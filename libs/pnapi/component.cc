@@ -30,7 +30,7 @@ using util::ComponentObserver;
  */
 Node::Node(PetriNet & net, util::ComponentObserver & observer,
            const std::string & name) :
-  net_(net), observer_(observer)
+  net_(net), observer_(observer), id_(0), nodeId_(0)
 {
   PNAPI_ASSERT(&observer.getPetriNet() == &net);
   history_.push_back(name);
@@ -42,7 +42,7 @@ Node::Node(PetriNet & net, util::ComponentObserver & observer,
  */
 Node::Node(PetriNet & net, util::ComponentObserver & observer,
            const Node & node, const std::string & prefix) :
-  net_(net), observer_(observer), history_(node.history_)
+  net_(net), observer_(observer), id_(0), nodeId_(0), history_(node.history_)
 {
   PNAPI_ASSERT(&observer.getPetriNet() == &net);
   if (!prefix.empty())
@@ -131,6 +131,18 @@ std::string Node::getName() const
 }
 
 
+/*!
+ * \brief returns the id of the node among the places resp. transitions of its net
+ *
+ * Ids are positions in PetriNet::getPlaces() resp. PetriNet::getTransitions()
+ * and stay valid until that container is compacted.
+ */
+unsigned int Node::getId() const
+{
+  return id_;
+}
+
+
 /*!
  * \brief adds a prefix to all names
  */
@@ -254,12 +266,10 @@ void Node::merge(Node & node, bool addArcWeights)
  */
 void Node::mergeNameHistory(const Node & node)
 {
-  std::deque<string> nodeHistory = node.history_;
+  PNAPI_ASSERT(&node != this);
 
-  // add history of node to this
-  std::deque<string> oldHistory = history_;
-  history_.insert(history_.end(), nodeHistory.begin(), nodeHistory.end());
-  observer_.updateNodeNameHistory(*this, oldHistory);
+  // add history of node to this; the name (i.e. the first entry) stays
+  history_.insert(history_.end(), node.history_.begin(), node.history_.end());
 }
 
 
@@ -338,6 +348,8 @@ unsigned int Place::getTokenCount() const
 }
 
 
+
+
 /*!
  * \brief sets the number of tokens lying on this place
  */
@@ -780,7 +792,7 @@ bool Transition::equalLabels(const Transition & t) const
 Arc::Arc(PetriNet & net, util::ComponentObserver & observer,
          Node & source, Node & target, unsigned int weight) :
   net_(net), observer_(observer),
-  source_(&source), target_(&target), weight_(weight)
+  source_(&source), target_(&target), weight_(weight), id_(0)
 {
   PNAPI_ASSERT(&observer.getPetriNet() == &net);
 
@@ -794,7 +806,7 @@ Arc::Arc(PetriNet & net, util::ComponentObserver & observer,
 Arc::Arc(PetriNet & net, util::ComponentObserver & observer, const Arc & arc) :
   net_(net), observer_(observer),
   source_(net.findNode(arc.source_->getName())),
-  target_(net.findNode(arc.target_->getName())), weight_(arc.weight_)
+  target_(net.findNode(arc.target_->getName())), weight_(arc.weight_), id_(0)
 {
   PNAPI_ASSERT(&observer.getPetriNet() == &net);
   PNAPI_ASSERT(source_ != NULL);
@@ -810,7 +822,7 @@ Arc::Arc(PetriNet & net, util::ComponentObserver & observer, const Arc & arc) :
 Arc::Arc(PetriNet & net, util::ComponentObserver & observer,
          const Arc & arc, Node & source, Node & target) :
   net_(net), observer_(observer),
-  source_(&source), target_(&target), weight_(arc.weight_)
+  source_(&source), target_(&target), weight_(arc.weight_), id_(0)
 {
   PNAPI_ASSERT(&observer.getPetriNet() == &net);
   PNAPI_ASSERT(net.containsNode(source));
@@ -34,7 +34,7 @@ class PetriNet;
 class Arc;
 class Marking;
 class Label;
-namespace util { class ComponentObserver; }
+namespace util { class ComponentObserver; struct NodeSlot; struct IdSlot; }
 
 
 /*!
@@ -54,6 +54,9 @@ class Node
 {
   /// observer needs to update pre- and postsets
   friend class util::ComponentObserver;
+  /// the net's containers maintain the ids
+  friend struct util::NodeSlot;
+  friend struct util::IdSlot;
 
 protected: /* protected variables */
   /// the petri net this node belongs to
@@ -62,6 +65,10 @@ protected: /* protected variables */
   util::ComponentObserver & observer_;
 
 private: /* private variables */
+  /// id among the places resp. transitions of the net
+  unsigned int id_;
+  /// id among all nodes of the net
+  unsigned int nodeId_;
   /// the set of roles (i.e. the history) of the node
   std::deque<std::string> history_;
   /// the preset of this node
@@ -108,6 +115,8 @@ public: /* public methods */
   bool isParallel(const Node &) const;
   /// returns the name of the node
   std::string getName() const;
+  /// returns the id of the node among the places resp. transitions of its net
+  unsigned int getId() const;
   /// returns the name history
   std::deque<std::string> getNameHistory() const;
   /// returns the node's preset
@@ -319,6 +328,9 @@ private: /* private methods */
  */
 class Arc
 {
+  /// the net's containers maintain the id
+  friend struct util::IdSlot;
+
 private:
   /// Petri net this arc belongs to
   PetriNet & net_;
@@ -330,6 +342,8 @@ private:
   Node * target_;
   /// weight of the arc
   unsigned int weight_;
+  /// id among the arcs of the net
+  unsigned int id_;
     
 public: /* public methods */
   /*!
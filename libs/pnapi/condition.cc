@@ -150,26 +150,22 @@ void Condition::addProposition(const formula::Proposition & p, bool conjunct)
  */
 void Condition::addMarking(const Marking & m)
 {
-  set<const Formula *> propositions;
-  set<Place *> places = m.getPetriNet().getPlaces();
+  std::vector<const Formula *> propositions;
+  propositions.reserve(m.getPetriNet().getPlaces().size());
   
-  PNAPI_FOREACH(p, places)
+  PNAPI_FOREACH(p, m.getPetriNet().getPlaces())
   {
-    propositions.insert(new FormulaEqual(**p, m[**p]));
+    propositions.push_back(new FormulaEqual(**p, m[**p]));
   }
+  const Conjunction marking(propositions);
 
   if (dynamic_cast<FormulaTrue *>(formula_) != NULL)
   {
-    (*this) = Conjunction(propositions, NULL);
+    (*this) = marking;
   }
   else
   {
-    (*this) = ((*formula_) || Conjunction(propositions, NULL));
-  }
-
-  PNAPI_FOREACH(it, propositions)
-  {
-    delete *it;
+    (*this) = ((*formula_) || marking);
   }
 }
 
@@ -214,11 +210,20 @@ void Condition::allOtherPlacesEmpty(PetriNet & net)
   }
   
   set<const Place *> remainingPlaces = util::setDifference(allPlaces, coveredPlaces);
-  
+  if (remainingPlaces.empty())
+  {
+    return;
+  }
+
+  // build the conjunction at once rather than extending it place by place
+  std::vector<const Formula *> children;
+  children.reserve(remainingPlaces.size() + 1);
+  children.push_back(formula_->clone());
   PNAPI_FOREACH(p, remainingPlaces)
   {
-    (*this) = (*formula_ && (**p == 0));
+    children.push_back(new FormulaEqual(**p, 0));
   }
+  (*this) = Conjunction(children);
 }
 
 /*!
@@ -180,6 +180,20 @@ Operator::Operator(const std::set<const Formula *> & children,
 #endif
 }
 
+/*!
+ * \brief constructor adopting the given children
+ *
+ * Unlike the other constructors, the children are not cloned but become
+ * part of this formula and are deleted with it. This way, formulae with
+ * many children can be built in one step instead of by repeatedly
+ * combining (and thus copying) a growing formula.
+ */
+Operator::Operator(const std::vector<const Formula *> & children) :
+  children_(children.begin(), children.end())
+{
+  PNAPI_ASSERT(children_.size() == children.size());
+}
+
 /*!
  * \brief constructor
  */
@@ -241,6 +255,15 @@ Conjunction::Conjunction(const std::set<const Formula *> & children,
   simplifyChildren();
 }
 
+/*!
+ * \brief constructor adopting the given children
+ */
+Conjunction::Conjunction(const std::vector<const Formula *> & children) :
+  Operator(children)
+{
+  simplifyChildren();
+}
+
 /*!
  * \brief constructor
  */
@@ -269,6 +292,15 @@ Disjunction::Disjunction(const std::set<const Formula *> & children,
   simplifyChildren();
 }
 
+/*!
+ * \brief constructor adopting the given children
+ */
+Disjunction::Disjunction(const std::vector<const Formula *> & children) :
+  Operator(children)
+{
+  simplifyChildren();
+}
+
 /*!
  * \brief constructor
  */
@@ -886,13 +918,12 @@ void Conjunction::simplifyChildren()
     }
     else
     {
-      const Operator * o = dynamic_cast<const Conjunction *> (*it);
+      // nested operators of the same kind hand their children over
+      Conjunction * o = dynamic_cast<Conjunction *> (const_cast<Formula *>(*it));
       if (o != NULL)
       {
-        PNAPI_FOREACH(it, o->getChildren())
-        {
-          children_.insert((*it)->clone());
-        }
+        children_.insert(o->children_.begin(), o->children_.end());
+        o->children_.clear();
         children_.erase(o);
         delete o;
       }
@@ -915,13 +946,12 @@ void Disjunction::simplifyChildren()
     }
     else
     {
-      const Operator * o = dynamic_cast<const Disjunction *> (*it);
+      // nested operators of the same kind hand their children over
+      Disjunction * o = dynamic_cast<Disjunction *> (const_cast<Formula *>(*it));
       if (o != NULL)
       {
-        PNAPI_FOREACH(it, o->getChildren())
-        {
-          children_.insert((*it)->clone());
-        }
+        children_.insert(o->children_.begin(), o->children_.end());
+        o->children_.clear();
         children_.erase(o);
         delete o;
       }
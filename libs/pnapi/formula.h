@@ -11,6 +11,8 @@
 
 #include "myio.h"
 
+#include <vector>
+
 namespace pnapi
 {
 
@@ -123,6 +125,8 @@ public:
   /// constructor
   Operator(const std::set<const Formula *> &,
            const std::map<const Place *, const Place *> * = NULL);
+  /// constructor adopting the given children
+  Operator(const std::vector<const Formula *> &);
   /// destructor
   ~Operator();
   //@}
@@ -221,6 +225,8 @@ public: /* public methods */
   /// constructor
   Conjunction(const std::set<const Formula *> &,
               const std::map<const Place *, const Place *> * = NULL);
+  /// constructor adopting the given children
+  Conjunction(const std::vector<const Formula *> &);
   //@}
 
   /*!
@@ -274,6 +280,8 @@ public: /* public methods */
   /// constructor
   Disjunction(const std::set<const Formula *> &,
               const std::map<const Place *, const Place *> * = NULL);
+  /// constructor adopting the given children
+  Disjunction(const std::vector<const Formula *> &);
   //@}
 
   /*!
@@ -48,11 +48,14 @@ Marking::Marking() : net_(NULL)
  *               instead of reading marking from n
  */
 Marking::Marking(PetriNet & n, bool empty) :
-  net_(&n)
+  m_(n.getPlaces().ids(), 0), net_(&n)
 {
-  PNAPI_FOREACH(p, n.getPlaces())
+  if (!empty)
   {
-    m_[*p] = empty ? 0 : ((*p)->getTokenCount());
+    PNAPI_FOREACH(p, n.getPlaces())
+    {
+      m_[(*p)->getId()] = (*p)->getTokenCount();
+    }
   }
 }
 
@@ -71,9 +74,13 @@ Marking::Marking(const Marking & m) :
 /*!
  * \brief   Another constructor.
  */
-Marking::Marking(std::map<const Place *, unsigned int> m, PetriNet * net) :
-  m_(m), net_(net)
+Marking::Marking(const std::map<const Place *, unsigned int> & m, PetriNet & net) :
+  m_(net.getPlaces().ids(), 0), net_(&net)
 {
+  PNAPI_FOREACH(it, m)
+  {
+    (*this)[*it->first] = it->second;
+  }
 }
 
 /*!
@@ -81,19 +88,19 @@ Marking::Marking(std::map<const Place *, unsigned int> m, PetriNet * net) :
  */
 Marking::Marking(const Marking & m, PetriNet * net, 
                   std::map<const Place *, const Place *> & placeMap) :
-  net_(net)
+  m_(net->getPlaces().ids(), 0), net_(net)
 {
-  PNAPI_FOREACH(it, m.m_)
+  PNAPI_FOREACH(p, m.net_->getPlaces())
   {
-    m_[placeMap[it->first]] = it->second;
+    (*this)[*placeMap[*p]] = m[**p];
   }
 }
 
 
 /*!
- * \brief   Returns the map..
+ * \brief   Returns the tokens, indexed by place index
  */
-const std::map<const Place *, unsigned int> & Marking::getMap() const
+const std::vector<unsigned int> & Marking::getTokens() const
 {
   return m_;
 }
@@ -107,16 +114,6 @@ PetriNet & Marking::getPetriNet() const
   return *net_;
 }
 
-std::map<const Place *, unsigned int>::const_iterator Marking::begin() const
-{
-  return m_.begin();
-}
-
-std::map<const Place *, unsigned int>::const_iterator Marking::end() const
-{
-  return m_.end();
-}
-
 /*!
  * \brief   Returns the size of the Marking
  */
@@ -137,8 +134,7 @@ bool Marking::activates(const Transition & t) const
 {
   PNAPI_FOREACH(f, t.getPresetArcs())
   {
-    map<const Place *, unsigned int>::const_iterator it = m_.find(static_cast<Place *>(&(*f)->getSourceNode()));
-    if((it == m_.end()) || ((**f).getWeight() > it->second))
+    if ((**f).getWeight() > (*this)[(*f)->getPlace()])
     {
       return false;
     }
@@ -157,23 +153,19 @@ bool Marking::activates(const Transition & t) const
  * 
  * \note successor will be allocated on the heap;
  *       you have to delete it, when you don't need it anymore
- * 
- * \todo review this and Automaton::dfs() to avoid memory leaks
  */
 Marking & Marking::getSuccessor(const Transition & t) const
 {
-  set<Node *> Ppre = t.getPreset();
-  set<Node *> Ppost = t.getPostset();
   Marking & m = *new Marking(*this);
 
-  PNAPI_FOREACH(p, Ppre)
+  PNAPI_FOREACH(f, t.getPresetArcs())
   {
-    m[*static_cast<Place *>(*p)] -= net_->findArc(**p, t)->getWeight();
+    m[(*f)->getPlace()] -= (*f)->getWeight();
   }
 
-  PNAPI_FOREACH(p, Ppost)
+  PNAPI_FOREACH(f, t.getPostsetArcs())
   {
-    m[*static_cast<Place *>(*p)] += net_->findArc(t, **p)->getWeight();
+    m[(*f)->getPlace()] += (*f)->getWeight();
   }
 
   return m;
@@ -185,7 +177,7 @@ Marking & Marking::getSuccessor(const Transition & t) const
  */
 unsigned int & Marking::operator [](const Place & offset)
 {
-  return m_[&offset];
+  return (*this)[offset.getId()];
 }
 
 /*!
@@ -193,9 +185,30 @@ unsigned int & Marking::operator [](const Place & offset)
  */
 unsigned int Marking::operator[](const Place & p) const
 {
-  map<const Place *, unsigned int>::const_iterator it = m_.find(&p); 
+  return (*this)[p.getId()];
+}
+
 
-  return ((it == m_.end()) ? 0 : it->second);
+/*!
+ * \brief   overloaded operator [] for Markings
+ * 
+ * \note    The marking grows if the net got new places.
+ */
+unsigned int & Marking::operator [](unsigned int index)
+{
+  if (index >= m_.size())
+  {
+    m_.resize(index + 1, 0);
+  }
+  return m_[index];
+}
+
+/*!
+ * \brief   overloaded operator [] for Markings
+ */
+unsigned int Marking::operator[](unsigned int index) const
+{
+  return ((index < m_.size()) ? m_[index] : 0);
 }
 
 
@@ -204,7 +217,29 @@ unsigned int Marking::operator[](const Place & p) const
  */
 bool Marking::operator==(const Marking & m) const
 {
-  return (m_ == m.getMap());
+  return (m_ == m.m_);
+}
+
+
+/*!
+ * \brief   hash value of the tokens
+ *
+ * FNV-1a over the token counts, followed by a final mixing step so that
+ * all bits of the result depend on all token counts; thus the low bits can
+ * directly be used as index of a hash table of any power-of-two size.
+ */
+unsigned int Marking::getHashValue() const
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned int i = 0; i < m_.size(); ++i)
+  {
+    hash = (hash ^ m_[i]) * 1099511628211ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return static_cast<unsigned int>(hash);
 }
 
 
@@ -213,11 +248,9 @@ bool Marking::operator==(const Marking & m) const
  */
 Marking & Marking::operator=(const Marking & m)
 {
-  PNAPI_ASSERT(this != &m);
-  
-  m_ = std::map<const Place *, unsigned int>(); // fixing cppcheck error
-  this->~Marking();
-  return *new (this) Marking(m);
+  m_ = m.m_;
+  net_ = m.net_;
+  return *this;
 }
 
 
@@ -226,7 +259,106 @@ Marking & Marking::operator=(const Marking & m)
  */
 void Marking::clear()
 {
-  m_.clear();
+  m_.assign(m_.size(), 0);
+}
+
+
+
+/****************************************************************************
+ *** Class FiringRule Function Definitions
+ ***************************************************************************/
+
+/*!
+ * \brief   Constructor
+ *
+ * Precomputes presets and effects of all transitions of the net.
+ */
+FiringRule::FiringRule(const PetriNet & net)
+{
+  // token change of each place, reused for every transition
+  std::vector<int> change(net.getPlaces().ids(), 0);
+
+  presetStart_.push_back(0);
+  deltaStart_.push_back(0);
+
+  PNAPI_FOREACH(t, net.getTransitions())
+  {
+    transitions_.push_back(*t);
+
+    PNAPI_FOREACH(f, (*t)->getPresetArcs())
+    {
+      const unsigned int p = (*f)->getPlace().getId();
+      preset_.push_back(std::make_pair(p, (*f)->getWeight()));
+      change[p] -= (*f)->getWeight();
+    }
+    PNAPI_FOREACH(f, (*t)->getPostsetArcs())
+    {
+      change[(*f)->getPlace().getId()] += (*f)->getWeight();
+    }
+
+    // places of a side condition are not affected
+    PNAPI_FOREACH(n, (*t)->getPreset())
+    {
+      const unsigned int p = static_cast<Place *>(*n)->getId();
+      if (change[p] != 0)
+      {
+        delta_.push_back(std::make_pair(p, change[p]));
+        change[p] = 0;
+      }
+    }
+    PNAPI_FOREACH(n, (*t)->getPostset())
+    {
+      const unsigned int p = static_cast<Place *>(*n)->getId();
+      if (change[p] != 0)
+      {
+        delta_.push_back(std::make_pair(p, change[p]));
+        change[p] = 0;
+      }
+    }
+
+    presetStart_.push_back(preset_.size());
+    deltaStart_.push_back(delta_.size());
+  }
+}
+
+
+/*!
+ * \brief   the transitions of the net
+ */
+const std::vector<Transition *> & FiringRule::getTransitions() const
+{
+  return transitions_;
+}
+
+
+/*!
+ * \brief   whether a marking activates the transition with number t
+ */
+bool FiringRule::activates(const Marking & m, unsigned int t) const
+{
+  const std::vector<unsigned int> & tokens = m.getTokens();
+  for (unsigned int i = presetStart_[t]; i < presetStart_[t + 1]; ++i)
+  {
+    if (tokens[preset_[i].first] < preset_[i].second)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/*!
+ * \brief   fires the transition with number t in the marking m
+ *
+ * \pre     m activates t
+ */
+void FiringRule::fire(Marking & m, unsigned int t) const
+{
+  for (unsigned int i = deltaStart_[t]; i < deltaStart_[t + 1]; ++i)
+  {
+    m[delta_[i].first] += delta_[i].second;
+  }
 }
 
 
@@ -9,7 +9,9 @@
 
 #include "config.h"
 
+#include <inttypes.h>
 #include <map>
+#include <vector>
 
 namespace pnapi
 {
@@ -23,14 +25,17 @@ class Place;
 /*!
  * \brief   Marking of all places of a net
  *
- * \note    In the future this class might contain a highly efficient
- *          implementation if necessary. For now, we use a simple one to
- *          determine the needed functionality.
+ * The tokens are stored in a flat vector indexed by Place::getId(),
+ * so reading, comparing and copying a marking touches contiguous memory only.
+ *
+ * \note    Adding places after deleting places may compact the ids of the
+ *          net's places, so markings of a net become invalid when its places
+ *          are changed.
  */
 class Marking
 {
 private: /* private variables */
-  std::map<const Place *, unsigned int> m_;
+  std::vector<unsigned int> m_;
   PetriNet * net_;
   
 public: /* public methods */
@@ -45,7 +50,7 @@ public: /* public methods */
   /// copy constructor
   Marking(const Marking &);
   /// constructor
-  Marking(std::map<const Place *, unsigned int>, PetriNet * = NULL);
+  Marking(const std::map<const Place *, unsigned int> &, PetriNet &);
   /// constructor
   Marking(const Marking &, PetriNet *, std::map<const Place *, const Place *> &);
   /// destructor
@@ -66,18 +71,16 @@ public: /* public methods */
    * \name getter
    */
   //@{
-  /// get mapping from places to their marking
-  const std::map<const Place *, unsigned int> & getMap() const;
-  /// get iterator to the first element in the marking map
-  std::map<const Place *, unsigned int>::const_iterator begin() const;
-  /// get end-iterator of the marking map
-  std::map<const Place *, unsigned int>::const_iterator end() const;
-  /// get size of the marking map
+  /// get the tokens indexed by place index
+  const std::vector<unsigned int> & getTokens() const;
+  /// get size of the marking, i.e. the number of places
   unsigned int size() const;
   /// get unterlying petri net
   PetriNet & getPetriNet() const;
   /// whether this marking is equal to a given other marking
   bool operator==(const Marking &) const;
+  /// get a hash value of the tokens
+  unsigned int getHashValue() const;
   /// whether marking activates a given transition
   bool activates(const Transition &) const;
   /// get the successor by fireing a given transition
@@ -86,9 +89,48 @@ public: /* public methods */
   unsigned int & operator[](const Place &);
   /// get the marking of a given place
   unsigned int operator[](const Place &) const;
+  /// get writing access to the marking of the place with a given index
+  unsigned int & operator[](unsigned int);
+  /// get the marking of the place with a given index
+  unsigned int operator[](unsigned int) const;
   //@}
 };
 
+
+/*!
+ * \brief   Firing rule of all transitions of a net over place indices
+ *
+ * For every transition, the weights of its preset arcs and its effect on
+ * each place are precomputed as (place index, value) pairs, which are kept
+ * in flat arrays. Checking whether a transition is activated and firing it
+ * thus needs neither arc lookups nor allocations.
+ */
+class FiringRule
+{
+private: /* private variables */
+  /// the transitions, numbered in iteration order of the net
+  std::vector<Transition *> transitions_;
+  /// first entry of each transition in preset_ (one more than transitions)
+  std::vector<unsigned int> presetStart_;
+  /// place indices and arc weights of the presets
+  std::vector<std::pair<unsigned int, unsigned int> > preset_;
+  /// first entry of each transition in delta_ (one more than transitions)
+  std::vector<unsigned int> deltaStart_;
+  /// place indices and token changes of the transitions
+  std::vector<std::pair<unsigned int, int> > delta_;
+  
+public: /* public methods */
+  /// constructor
+  explicit FiringRule(const PetriNet &);
+  
+  /// the transitions of the net, a transition's position is its number
+  const std::vector<Transition *> & getTransitions() const;
+  /// whether a marking activates the transition with the given number
+  bool activates(const Marking &, unsigned int) const;
+  /// fires the transition with the given number in a marking
+  void fire(Marking &, unsigned int) const;
+};
+
 } /* namespace pnapi */
 
 #endif /* PNAPI_MARKING_H */
@@ -12,6 +12,7 @@
 #include "util.h"
 
 #include <fstream>
+#include <sstream>
 
 using std::endl;
 using std::ifstream;
@@ -64,6 +65,9 @@ std::ostream & operator<<(std::ostream & os, const PetriNet & net)
  * Reads a Petri net from a stream (in most cases backed by a file).
  * The format of the stream data is not determined automatically.
  * You have to set it explicitly using a stream manipulator from pnapi::io.
+ * 
+ * The net is emptied and then parsed into directly, so a large net is not
+ * copied out of the parser.
  */
 std::istream & operator>>(std::istream & is, PetriNet & net) throw (exception::InputError)
 {
@@ -71,7 +75,8 @@ std::istream & operator>>(std::istream & is, PetriNet & net) throw (exception::I
   {
   case util::OWFN:
   {
-    net = parser::owfn::parse(is);
+    net = PetriNet();
+    parser::owfn::parse(is, net);
 
     net.meta_ = util::MetaData::data(is);
     break;
@@ -79,7 +84,8 @@ std::istream & operator>>(std::istream & is, PetriNet & net) throw (exception::I
 
   case util::PNML:
   {
-    net = parser::pnml::parse(is);
+    net = PetriNet();
+    parser::pnml::parse(is, net);
 
     net.meta_ = util::MetaData::data(is);
     break;
@@ -87,7 +93,8 @@ std::istream & operator>>(std::istream & is, PetriNet & net) throw (exception::I
 
   case util::LOLA:
   {
-    net = parser::lola::parse(is);
+    net = PetriNet();
+    parser::lola::parse(is, net);
 
     net.meta_ = util::MetaData::data(is);
     break;
@@ -95,7 +102,8 @@ std::istream & operator>>(std::istream & is, PetriNet & net) throw (exception::I
 
   case util::WOFLAN:
   {
-    net = parser::woflan::parse(is);
+    net = PetriNet();
+    parser::woflan::parse(is, net);
 
     net.meta_ = util::MetaData::data(is);
     break;
@@ -130,6 +138,8 @@ std::ostream & operator<<(std::ostream & os, const Automaton & sa)
 
 /*!
  * \brief Reads an Automaton file and creates an object from it.
+ * 
+ * As for nets, the automaton is emptied and parsed into directly.
  */
 std::istream & operator>>(std::istream &is, Automaton &sa)
 {
@@ -137,7 +147,8 @@ std::istream & operator>>(std::istream &is, Automaton &sa)
   {
   case util::SA:
   {
-    sa = parser::sa::parse(is);
+    sa = Automaton();
+    parser::sa::parse(is, sa);
     break;
   }
   default: PNAPI_ASSERT(false); /* unsupported format */
@@ -618,9 +629,36 @@ bool compareContainerElements(Arc * f1, Arc * f2)
 }
 
 
-bool compareContainerElements(const formula::Formula *, const formula::Formula *)
+/*!
+ * \brief orders formulas by type, propositions by place and tokens,
+ *        and other formulas by their OWFN representation
+ *
+ * \note  Thus the output of a formula does not depend on where its
+ *        children are stored in memory.
+ */
+bool compareContainerElements(const formula::Formula * f1, const formula::Formula * f2)
 {
-  return false;
+  if(f1->getType() != f2->getType())
+  {
+    return (f1->getType() < f2->getType());
+  }
+
+  const formula::Proposition * p1 = dynamic_cast<const formula::Proposition *>(f1);
+  const formula::Proposition * p2 = dynamic_cast<const formula::Proposition *>(f2);
+  if((p1 != NULL) && (p2 != NULL))
+  {
+    if(p1->getPlace().getName() != p2->getPlace().getName())
+    {
+      return compareContainerElements(p1->getPlace().getName(), p2->getPlace().getName());
+    }
+    return (p1->getTokens() < p2->getTokens());
+  }
+
+  std::ostringstream s1;
+  std::ostringstream s2;
+  s1 << owfn << *f1;
+  s2 << owfn << *f2;
+  return (s1.str() < s2.str());
 }
 
 bool compareContainerElements(Label *, Label *)
@@ -32,6 +32,7 @@
 #define PNAPI_MYIO_H
 
 #include "exception.h"
+#include "nodelist.h"
 #include "util.h"
 
 #include <vector>
@@ -671,6 +672,21 @@ std::ostream & operator<<(std::ostream & os, const std::set<T> & s)
   return os << v;
 }
 
+/*!
+ * \brief write the elements of a net's container, seperated by given delimeter, to stream
+ */
+template <typename T, typename Slot>
+std::ostream & operator<<(std::ostream & os, const pnapi::util::NodeList<T, Slot> & l)
+{
+  // sort the elements like those of a set
+  std::vector<T *> v(l.begin(), l.end());
+  bool (*c)(T *, T *) = compareContainerElements;
+  std::sort(v.begin(), v.end(), c);
+
+  // output the sorted vector
+  return os << v;
+}
+
 
 template <typename T> std::ostream &
 operator<<(std::ostream & os,
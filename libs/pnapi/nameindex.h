@@ -0,0 +1,174 @@
+// -*- C++ -*-
+
+/*!
+ * \file    nameindex.h
+ *
+ * \brief   hash index of nodes by name
+ */
+
+#ifndef PNAPI_NAMEINDEX_H
+#define PNAPI_NAMEINDEX_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace pnapi
+{
+
+namespace util
+{
+
+/*!
+ * \brief   Hash index from names to objects of one type
+ *
+ * Open addressing with linear probing over a power-of-two sized array,
+ * which doubles whenever it becomes half full. Erasing an entry shifts
+ * the following entries of its probe sequence back, so no tombstones
+ * are needed.
+ *
+ * Names can be looked up as character range, so scanners can resolve
+ * names straight from their buffer without building a std::string.
+ */
+template <class T>
+class NameIndex
+{
+private: /* private types */
+  /// an entry; free slots have no object
+  struct Entry
+  {
+    std::string name;
+    unsigned int hash;
+    T * object;
+
+    Entry() : hash(0), object(NULL) {}
+  };
+
+private: /* private variables */
+  /// the slots
+  std::vector<Entry> slots_;
+  /// the number of entries
+  size_t entries_;
+
+public: /* public methods */
+  /// constructor
+  NameIndex() : slots_(16), entries_(0) {}
+
+  /// the number of entries
+  size_t size() const { return entries_; }
+
+  /// the object with the given name or NULL
+  T * find(const std::string & name) const
+  {
+    return find(name.data(), name.size());
+  }
+
+  /// the object whose name are the given characters or NULL
+  T * find(const char * name, size_t length) const
+  {
+    const size_t slot = lookup(name, length, hash(name, length));
+    return slots_[slot].object;
+  }
+
+  /// adds an object under a name which is not yet in the index
+  void insert(const std::string & name, T * object)
+  {
+    if (2 * (entries_ + 1) > slots_.size())
+    {
+      std::vector<Entry> old(2 * slots_.size());
+      old.swap(slots_);
+      for (size_t i = 0; i < old.size(); ++i)
+      {
+        if (old[i].object != NULL)
+        {
+          place(old[i]);
+        }
+      }
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.hash = hash(name.data(), name.size());
+    entry.object = object;
+    place(entry);
+    ++entries_;
+  }
+
+  /// removes the entry with the given name, if any
+  void erase(const std::string & name)
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t i = lookup(name.data(), name.size(), hash(name.data(), name.size()));
+    if (slots_[i].object == NULL)
+    {
+      return;
+    }
+
+    // move entries back which could not be placed at their home slot
+    for (size_t j = (i + 1) & mask; slots_[j].object != NULL; j = (j + 1) & mask)
+    {
+      const size_t home = slots_[j].hash & mask;
+      const bool reachable = (i <= j) ? ((i < home) && (home <= j))
+                                      : ((i < home) || (home <= j));
+      if (!reachable)
+      {
+        slots_[i] = slots_[j];
+        i = j;
+      }
+    }
+
+    slots_[i] = Entry();
+    --entries_;
+  }
+
+  /// removes all entries
+  void clear()
+  {
+    slots_.assign(16, Entry());
+    entries_ = 0;
+  }
+
+  /// FNV-1a hash of a character range
+  static unsigned int hash(const char * name, size_t length)
+  {
+    unsigned int result = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+      result = (result ^ static_cast<unsigned char>(name[i])) * 16777619u;
+    }
+    return result;
+  }
+
+private: /* private methods */
+  /// the slot holding the given name or the free slot ending its probe sequence
+  size_t lookup(const char * name, size_t length, unsigned int h) const
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t i = h & mask;
+    while ((slots_[i].object != NULL) &&
+           ((slots_[i].hash != h) || (slots_[i].name.size() != length) ||
+            (memcmp(slots_[i].name.data(), name, length) != 0)))
+    {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+  /// puts an entry into the first free slot of its probe sequence
+  void place(const Entry & entry)
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t i = entry.hash & mask;
+    while (slots_[i].object != NULL)
+    {
+      i = (i + 1) & mask;
+    }
+    slots_[i] = entry;
+  }
+};
+
+} /* namespace util */
+
+} /* namespace pnapi */
+
+#endif /* PNAPI_NAMEINDEX_H */
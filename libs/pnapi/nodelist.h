@@ -0,0 +1,208 @@
+// -*- C++ -*-
+
+/*!
+ * \file    nodelist.h
+ *
+ * \brief   insertion ordered containers of nodes and arcs
+ */
+
+#ifndef PNAPI_NODELIST_H
+#define PNAPI_NODELIST_H
+
+#include "component.h"
+
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace pnapi
+{
+
+namespace util
+{
+
+/*!
+ * \brief   the id of a node in PetriNet::getNodes()
+ */
+struct NodeSlot
+{
+  static unsigned int & of(Node & n) { return n.nodeId_; }
+};
+
+/*!
+ * \brief   the id of a place, transition or arc in its typed container
+ */
+struct IdSlot
+{
+  static unsigned int & of(Node & n) { return n.id_; }
+  static unsigned int & of(Arc & a) { return a.id_; }
+};
+
+
+/*!
+ * \brief   Insertion ordered container of net components
+ *
+ * The elements are kept in a vector in the order they were inserted.
+ * Each element stores its position (its id) in a member selected by
+ * the Slot policy, so membership tests and removal take constant time.
+ * A removed element leaves a tombstone (NULL) behind, which iterators
+ * skip; ids of the remaining elements stay valid until the tombstones
+ * outnumber the elements and an insertion compacts the vector.
+ *
+ * Iterators hold a position rather than a pointer into the vector, so
+ * they survive insertions and removals as long as no compaction takes
+ * place. Hence, do not insert into a container while iterating over it.
+ */
+template <class T, class Slot>
+class NodeList
+{
+public: /* public types */
+  /// iterator over the elements, skipping tombstones
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T * value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T * const * pointer;
+    typedef T * const & reference;
+
+    const_iterator() : slots_(NULL), i_(0) {}
+    const_iterator(const std::vector<T *> & slots, size_t i) : slots_(&slots), i_(i) { skip(); }
+
+    reference operator*() const { return (*slots_)[i_]; }
+    pointer operator->() const { return &(*slots_)[i_]; }
+    const_iterator & operator++() { ++i_; skip(); return *this; }
+    const_iterator operator++(int) { const_iterator result = *this; ++*this; return result; }
+    bool operator==(const const_iterator & other) const { return position() == other.position(); }
+    bool operator!=(const const_iterator & other) const { return position() != other.position(); }
+
+  private:
+    /// the position, where everything behind the last slot counts as end
+    size_t position() const
+    {
+      return ((slots_ == NULL) || (i_ < slots_->size())) ? i_ : slots_->size();
+    }
+
+    /// moves forward to the next element which is no tombstone
+    void skip()
+    {
+      while ((i_ < slots_->size()) && ((*slots_)[i_] == NULL))
+      {
+        ++i_;
+      }
+    }
+
+    const std::vector<T *> * slots_;
+    size_t i_;
+  };
+
+  typedef const_iterator iterator;
+  typedef T * value_type;
+
+private: /* private variables */
+  /// the elements by id; removed elements are NULL
+  std::vector<T *> slots_;
+  /// the number of elements
+  size_t size_;
+
+public: /* public methods */
+  /// constructor
+  NodeList() : size_(0) {}
+
+  /// iterator to the first element
+  const_iterator begin() const { return const_iterator(slots_, 0); }
+  /// iterator behind the last element
+  const_iterator end() const { return const_iterator(slots_, slots_.size()); }
+
+  /// the number of elements
+  size_t size() const { return size_; }
+  /// whether there are no elements
+  bool empty() const { return size_ == 0; }
+  /// one more than the largest id in use
+  unsigned int ids() const { return slots_.size(); }
+  /// the element with the given id or NULL
+  T * at(unsigned int id) const { return (id < slots_.size()) ? slots_[id] : NULL; }
+
+  /// whether the element is contained (0 or 1)
+  size_t count(T * t) const
+  {
+    if (t == NULL)
+    {
+      return 0;
+    }
+    const unsigned int id = Slot::of(*t);
+    return ((id < slots_.size()) && (slots_[id] == t)) ? 1 : 0;
+  }
+
+  /// the element as iterator, or end() if it is not contained
+  const_iterator find(T * t) const
+  {
+    return count(t) ? const_iterator(slots_, Slot::of(*t)) : end();
+  }
+
+  /// appends an element, assigning it the next id
+  void insert(T * t)
+  {
+    if ((slots_.size() >= 16) && (2 * size_ < slots_.size()))
+    {
+      compact();
+    }
+    Slot::of(*t) = slots_.size();
+    slots_.push_back(t);
+    ++size_;
+  }
+
+  /// removes an element, leaving a tombstone
+  void erase(T * t)
+  {
+    if (!count(t))
+    {
+      return;
+    }
+    slots_[Slot::of(*t)] = NULL;
+    --size_;
+
+    // trailing tombstones can go right away
+    while (!slots_.empty() && (slots_.back() == NULL))
+    {
+      slots_.pop_back();
+    }
+  }
+
+  /// removes all tombstones and renumbers the elements densely
+  void compact()
+  {
+    size_t next = 0;
+    for (size_t i = 0; i < slots_.size(); ++i)
+    {
+      if (slots_[i] != NULL)
+      {
+        slots_[next] = slots_[i];
+        Slot::of(*slots_[next]) = next;
+        ++next;
+      }
+    }
+    slots_.resize(next);
+  }
+
+  /// removes all elements
+  void clear()
+  {
+    slots_.clear();
+    size_ = 0;
+  }
+
+  /// copies the elements into a set
+  operator std::set<T *>() const
+  {
+    return std::set<T *>(begin(), end());
+  }
+};
+
+} /* namespace util */
+
+} /* namespace pnapi */
+
+#endif /* PNAPI_NODELIST_H */
@@ -37,8 +37,21 @@ namespace pnapi { namespace parser { namespace owfn
  */
 PetriNet parse(std::istream & is)
 {
-  Parser myParser;
-  return myParser.parse(is);
+  PetriNet net;
+  parse(is, net);
+  return net;
+}
+
+/*!
+ * \brief parses stream contents into the given net
+ * 
+ * \pre net is empty
+ * \note If an exception is thrown, net is left partially parsed.
+ */
+void parse(std::istream & is, PetriNet & net)
+{
+  Parser myParser(net);
+  myParser.parse(is);
 }
 
 namespace yy
@@ -82,4 +95,15 @@ Parser::Parser() :
 {
 }
 
+/*!
+ * \brief constructor generating the given petrinet
+ */
+Parser::Parser(PetriNet & net) :
+  AbstractParser<yy::BisonParser, yy::Lexer, Parser>(net),
+  transition_(NULL), place_(NULL), target_(NULL), source_(NULL),
+  port_(NULL), label_(NULL), capacity_(0),
+  markInitial_(false), finalMarking_(NULL), placeSetType_(false), wildcardGiven_(false)
+{
+}
+
 } } } /* namespace pnapi::parser::owfn */
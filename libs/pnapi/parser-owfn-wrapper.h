@@ -124,6 +124,8 @@ private: /* private variables */
 public: /* public methods */
   /// constructor
   Parser();
+  /// constructor generating the given petrinet
+  Parser(PetriNet &);
   
 protected: /* protected methods */
   /// make this class concrete
@@ -37,8 +37,21 @@ namespace pnapi { namespace parser { namespace pnml
  */
 PetriNet parse(std::istream & is)
 {
-  Parser myParser;
-  return myParser.parse(is);
+  PetriNet net;
+  parse(is, net);
+  return net;
+}
+
+/*!
+ * \brief parses stream contents into the given net
+ * 
+ * \pre net is empty
+ * \note If an exception is thrown, net is left partially parsed.
+ */
+void parse(std::istream & is, PetriNet & net)
+{
+  Parser myParser(net);
+  myParser.parse(is);
 }
 
 namespace yy
@@ -105,6 +118,16 @@ Parser::Parser() :
 {
 }
 
+/*!
+ * \brief constructor generating the given petrinet
+ */
+Parser::Parser(PetriNet & net) :
+  AbstractParser<yy::BisonParser, yy::Lexer, Parser>(net),
+  currentMarking(NULL), current_depth(0), last_interesting_depth(0),
+  ignoring(false), file_part(T_NONE)
+{
+}
+
 /*!
  * \brief throw an error
  */
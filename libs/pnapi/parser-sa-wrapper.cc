@@ -37,8 +37,21 @@ namespace pnapi { namespace parser { namespace sa
  */
 Automaton parse(std::istream & is)
 {
-  Parser myParser;
-  return myParser.parse(is);
+  Automaton sa;
+  parse(is, sa);
+  return sa;
+}
+
+/*!
+ * \brief parses stream contents into the given automaton
+ * 
+ * \pre sa is empty
+ * \note If an exception is thrown, sa is left partially parsed.
+ */
+void parse(std::istream & is, Automaton & sa)
+{
+  Parser myParser(sa);
+  myParser.parse(is);
 }
 
 namespace yy
@@ -76,7 +89,16 @@ void BisonParser::error(const location_type &, const std::string & msg)
  */
 Parser::Parser() :
   AbstractParser<yy::BisonParser, yy::Lexer, Parser>(),
-  state_(NULL), final_(false), initial_(false)
+  automaton_(ownAutomaton_), state_(NULL), final_(false), initial_(false)
+{
+}
+
+/*!
+ * \brief constructor generating the given automaton
+ */
+Parser::Parser(Automaton & automaton) :
+  AbstractParser<yy::BisonParser, yy::Lexer, Parser>(),
+  automaton_(automaton), state_(NULL), final_(false), initial_(false)
 {
 }
 
@@ -76,8 +76,10 @@ class Parser : public AbstractParser<yy::BisonParser, yy::Lexer, Parser>
   friend void AbstractLexer<Parser, yy::BisonParser::semantic_type, SaFlexLexer>::LexerError(const char *);
     
 private: /* private variables */
+  /// automaton generated if no target is given
+  Automaton ownAutomaton_;
   /// generated automaton
-  Automaton automaton_;
+  Automaton & automaton_;
   /// temporary list of idents
   std::vector<std::string> identlist;
   /// input labels
@@ -109,6 +111,8 @@ private: /* private variables */
 public: /* public methods */
   /// constructor
   Parser();
+  /// constructor generating the given automaton
+  Parser(Automaton &);
   /// parses stream contents with the associated parser
   const Automaton & parse(std::istream &);
   
@@ -48,12 +48,16 @@ protected: /* protected variables */
   L lexer_;
   /// input stream
   std::istream * is_; 
+  /// petrinet generated if no target is given
+  PetriNet ownNet_;
   /// generated petrinet
-  PetriNet net_;
+  PetriNet & net_;
   
 public: /* public methods */
   /// constructor
   AbstractParser();
+  /// constructor generating the given petrinet
+  AbstractParser(PetriNet &);
   /// "assertion"
   void check(bool, const std::string &);
   /// parses stream contents with the associated parser
@@ -91,30 +95,40 @@ namespace lola
 {
 /// parses stream contents with the associated parser
 PetriNet parse(std::istream &);
+/// parses stream contents into the given empty net
+void parse(std::istream &, PetriNet &);
 } /* namespace lola */
 
 namespace owfn
 {
 /// parses stream contents with the associated parser
 PetriNet parse(std::istream &);
+/// parses stream contents into the given empty net
+void parse(std::istream &, PetriNet &);
 } /* namespace owfn */
 
 namespace pnml
 {
 /// parses stream contents with the associated parser
 PetriNet parse(std::istream &);
+/// parses stream contents into the given empty net
+void parse(std::istream &, PetriNet &);
 } /* namespace pnml */
 
 namespace sa
 {
 /// parses stream contents with the associated parser
 Automaton parse(std::istream &);
+/// parses stream contents into the given empty automaton
+void parse(std::istream &, Automaton &);
 } /* namespace sa */
 
 namespace woflan
 {
 /// parses stream contents with the associated parser
 PetriNet parse(std::istream &);
+/// parses stream contents into the given empty net
+void parse(std::istream &, PetriNet &);
 } /* namespace woflan */
 
 } /* namespace parser */
@@ -137,7 +151,21 @@ namespace parser
  */
 template <class P, class L, class C>
 AbstractParser<P, L, C>::AbstractParser() :
-  parser_(*static_cast<C *>(this)), lexer_(*static_cast<C *>(this)), is_(NULL)
+  parser_(*static_cast<C *>(this)), lexer_(*static_cast<C *>(this)), is_(NULL),
+  net_(ownNet_)
+{
+}
+
+/*!
+ * \brief constructor generating the given petrinet
+ * 
+ * Nodes, arcs and labels are created in the target directly, so the
+ * parsed net does not have to be copied out of the parser.
+ */
+template <class P, class L, class C>
+AbstractParser<P, L, C>::AbstractParser(PetriNet & target) :
+  parser_(*static_cast<C *>(this)), lexer_(*static_cast<C *>(this)), is_(NULL),
+  net_(target)
 {
 }
 
@@ -64,6 +64,7 @@
 #include <iostream>
 #include <list>
 #include <algorithm>
+#include <ctime>
 
 using std::cerr;
 using std::cout;
@@ -73,6 +74,7 @@ using std::list;
 using std::map;
 using std::pair;
 using std::set;
+using std::vector;
 
 
 // #define __REDUCE_CHECK_FINAL(x) (reducablePlaces_->count(x) > 0)
@@ -224,7 +226,7 @@ unsigned int PetriNet::reduce_dead_nodes()
     set<Transition *> deadTransitions;
 
     // find insufficiently marked places with empty preset
-    PNAPI_FOREACH(p, places_)
+    PNAPI_FOREACH(p, reductionCache_->scopeP_)
     {
       if ( ((*p)->getPreset().empty() or // precondition 1a
              includes((*p)->getPostset().begin(), (*p)->getPostset().end(),
@@ -257,6 +259,9 @@ unsigned int PetriNet::reduce_dead_nodes()
       }
     }
 
+    // only the neighbourhood of the removed nodes may become dead
+    unsigned int since = reductionCache_->changes();
+
     // remove dead places and transitions
     PNAPI_FOREACH(p, deadPlaces)
     {
@@ -271,6 +276,8 @@ unsigned int PetriNet::reduce_dead_nodes()
       deleteTransition(**t);
       ++result;
     }
+
+    reductionCache_->narrowScope(since, 1);
   }
 
   /*
@@ -527,7 +534,7 @@ unsigned int PetriNet::reduce_rule_3t()
   map<Transition *, Transition *> replaceRelation;
 
   // iterate transitions
-  PNAPI_FOREACH(t1, transitions_)
+  PNAPI_FOREACH(t1, reductionCache_->scopeT_)
   { 
     /*
      * Since parallel transitions form an equivalence class, 
@@ -682,7 +689,21 @@ unsigned int PetriNet::reduce_rule_4()
     }
   }
 
-  // STEP 2: check those places for equality
+  /*
+   * STEP 2: check those places for equality
+   * 
+   * Equal transitions have equal postsets, so only places whose
+   * posttransitions share the postset need to be compared.
+   */
+  map<set<Node *>, vector<Place *> > buckets;
+  map<Place *, unsigned int> position; // position of a place in its bucket
+  PNAPI_FOREACH(p, relevantPlaces)
+  {
+    vector<Place *> & bucket = buckets[(*((*p)->getPostset().begin()))->getPostset()];
+    position[*p] = bucket.size();
+    bucket.push_back(*p);
+  }
+
   map<Place *,Place *> equalPlaces;
   set<Place *> seenPlaces; 
 
@@ -691,16 +712,17 @@ unsigned int PetriNet::reduce_rule_4()
     if(seenPlaces.find(*p1) != seenPlaces.end())
       continue;
 
-    for(set<Place *>::iterator p2 = (++p1)--; // precondition 1
-         p2 != relevantPlaces.end(); ++p2)
+    Transition * t1 = static_cast<Transition *>(*((*p1)->getPostset().begin()));
+    const vector<Place *> & bucket = buckets[t1->getPostset()];
+    for(unsigned int i = position[*p1] + 1; i < bucket.size(); ++i) // precondition 1
     {
-      Transition * t1 = static_cast<Transition *>(*((*p1)->getPostset().begin()));
-      Transition * t2 = static_cast<Transition *>(*((*p2)->getPostset().begin()));
+      Place * p2 = bucket[i];
+      Transition * t2 = static_cast<Transition *>(*(p2->getPostset().begin()));
       if( (t1 != t2) &&
-          (reduce_isEqual(t1,t2,*p1,*p2)) ) // precondition 4
+          (reduce_isEqual(t1,t2,*p1,p2)) ) // precondition 4
       {
-        equalPlaces[*p1] = (*p2);
-        seenPlaces.insert(*p2);
+        equalPlaces[*p1] = p2;
+        seenPlaces.insert(p2);
       }
     }
   }
@@ -733,6 +755,7 @@ unsigned int PetriNet::reduce_rule_4()
     
     // STEP 3.2: set marking
     p1->setTokenCount(p1->getTokenCount() + p2->getTokenCount());
+    reductionCache_->touch(*p1);
 
     // save history
     p1->mergeNameHistory(*p2);
@@ -831,13 +854,8 @@ unsigned int PetriNet::reduce_rule_5()
   // transitions must not be in more than one reduction at once
   map<Node *,bool> seenTransitions;
   
-  PNAPI_FOREACH(t, transitions_)
-  {
-    seenTransitions[*t] = false;
-  }
-  
   // precondition 1 and 2
-  set<Place *> candidates = util::setDifference(util::setDifference(places_, reductionCache_->emptyPresetP_),
+  set<Place *> candidates = util::setDifference(util::setDifference(set<Place *>(places_), reductionCache_->emptyPresetP_),
                                                 reductionCache_->emptyPostsetP_);
 
   // iterate internal places
@@ -981,11 +999,13 @@ unsigned int PetriNet::reduce_rule_5()
       Transition * t = static_cast<Transition *>(*((*p)->getPostset().begin()));
 
       (*p)->setTokenCount((*p)->getTokenCount() - v_[*p]); // consume tokens
+      reductionCache_->touch(**p);
 
       PNAPI_FOREACH(a, t->getPostsetArcs())
       {
         Place * postP = static_cast<Place *>(&((*a)->getTargetNode())); 
         postP->setTokenCount(postP->getTokenCount() + (*a)->getWeight()); // produce tokens
+        reductionCache_->touch(*postP);
       }
     }
     
@@ -1103,10 +1123,6 @@ unsigned int PetriNet::reduce_rule_6()
 
   // transitions must not be in more than one reduction at once
   map<Node *, bool> seenTransitions;
-  PNAPI_FOREACH(t, transitions_)
-  {
-    seenTransitions[*t] = false;
-  }
 
   // precondition 1 and 3
   set<Place *> candidates = util::setDifference(reductionCache_->singletonPresetP_,
@@ -1335,7 +1351,7 @@ unsigned int PetriNet::reduce_rule_7()
   set<Place *> obsoletePlaces;
 
   // iterate internal places
-  PNAPI_FOREACH(p, places_)
+  PNAPI_FOREACH(p, reductionCache_->scopeP_)
   {
     if(!((*p)->getPreset() == (*p)->getPostset())) // precondition 1
     {
@@ -1447,11 +1463,6 @@ unsigned int PetriNet::reduce_rule_8()
   // don't reduce "backup"-transitions
   map<Node *, bool> seenTransitions;
 
-  PNAPI_FOREACH(t, transitions_)
-  {
-    seenTransitions[*t] = false;
-  }
-
   // iterate transitions
   PNAPI_FOREACH(t, transitions_)
   {
@@ -1570,11 +1581,6 @@ unsigned int PetriNet::reduce_rule_9()
   // transitions must not be in more than one reduction at once
   map<Node *, bool> seenTransitions;
 
-  PNAPI_FOREACH(t, transitions_)
-  {
-    seenTransitions[*t] = false;
-  }
-
   // precondition 2a and 3
   set<Place *> candidates = util::setDifference(reductionCache_->singletonPostsetP_,
                                                 reductionCache_->emptyPresetP_);
@@ -1640,9 +1646,11 @@ unsigned int PetriNet::reduce_rule_9()
       { 
         Place * pi = static_cast<Place *>(&((*a)->getTargetNode()));
         pi->setTokenCount(pi->getTokenCount() + ((*a)->getWeight() * tokens));
+        reductionCache_->touch(*pi);
       }
 
       (*p)->setTokenCount(0);
+      reductionCache_->touch(**p);
     }
 
     // STEP 2:
@@ -1754,16 +1762,11 @@ unsigned int PetriNet::reduce_identical_places()
   // these places either already will be deleted or must not be deleted in this iteration
   map<Node *, bool> seenPlaces;  
 
-  PNAPI_FOREACH(p, places_)
-  {
-    seenPlaces[*p] = false;
-  }
-
 
   // trace(TRACE_DEBUG, "[PN]\tApplying rule RB1 (elimination of identical places)...\n");
 
   // iterate the internal places
-  PNAPI_FOREACH(p1, places_)
+  PNAPI_FOREACH(p1, reductionCache_->scopeP_)
   {
     if( (seenPlaces[*p1]) ||
         ((*p1)->getTokenCount() > 0) ) // precondition 5
@@ -1802,8 +1805,15 @@ unsigned int PetriNet::reduce_identical_places()
     }
 
 
-    // get a pretransition
-    Node * preTransition = *((*p1)->getPreset().begin());
+    // get the pretransition with the smallest postset (identical places are found there, too)
+    Node * preTransition = NULL;
+    PNAPI_FOREACH(t, (*p1)->getPreset())
+    {
+      if((preTransition == NULL) || ((*t)->getPostset().size() < preTransition->getPostset().size()))
+      {
+        preTransition = *t;
+      }
+    }
 
     // test for null-pointer (i.e. preset was empty)
     if(preTransition != NULL)
@@ -1855,8 +1865,15 @@ unsigned int PetriNet::reduce_identical_places()
     }
     else // if there was no pretransition
     {
-      // get a posttransition
-      Node * postTransition = *((*p1)->getPostset().begin());
+      // get the posttransition with the smallest preset
+      Node * postTransition = NULL;
+      PNAPI_FOREACH(t, (*p1)->getPostset())
+      {
+        if((postTransition == NULL) || ((*t)->getPreset().size() < postTransition->getPreset().size()))
+        {
+          postTransition = *t;
+        }
+      }
 
       // check for null-pointer (i.e. postset was empty, too)
       if(postTransition != NULL)
@@ -1956,16 +1973,10 @@ unsigned int PetriNet::reduce_identical_transitions()
   map<Node *, bool> backupTransition; // must not be reduced
   map<Node *, bool> obsoleteTransition; // must not be backup transitions
 
-  PNAPI_FOREACH(t, transitions_)
-  {
-    backupTransition[*t] = false;
-    obsoleteTransition[*t] = false;
-  }
-
   // trace(TRACE_DEBUG, "[PN]\tApplying rule RB2 (elimination of identical transitions)...\n");
 
   // iterate the transitions
-  PNAPI_FOREACH(t1, transitions_)
+  PNAPI_FOREACH(t1, reductionCache_->scopeT_)
   {
     if(backupTransition[*t1])
     {
@@ -2003,8 +2014,15 @@ unsigned int PetriNet::reduce_identical_transitions()
     }
 
 
-    // get a preplace
-    Node * prePlace = *((*t1)->getPreset().begin());
+    // get the preplace with the smallest postset (identical transitions are found there, too)
+    Node * prePlace = NULL;
+    PNAPI_FOREACH(p, (*t1)->getPreset())
+    {
+      if((prePlace == NULL) || ((*p)->getPostset().size() < prePlace->getPostset().size()))
+      {
+        prePlace = *p;
+      }
+    }
 
     // check for null-pointer (i.e. preset was empty)
     if(prePlace != NULL)
@@ -2059,8 +2077,15 @@ unsigned int PetriNet::reduce_identical_transitions()
     }
     else // if there exists no preplace
     {
-      // get a postplace
-      Node * postPlace = *((*t1)->getPostset().begin());
+      // get the postplace with the smallest preset
+      Node * postPlace = NULL;
+      PNAPI_FOREACH(p, (*t1)->getPostset())
+      {
+        if((postPlace == NULL) || ((*p)->getPreset().size() < postPlace->getPreset().size()))
+        {
+          postPlace = *p;
+        }
+      }
 
       // check for null-pointer (i.e. postset was empty, too)
       if(postPlace != NULL)
@@ -2170,15 +2195,10 @@ unsigned int PetriNet::reduce_series_places()
 
   // places must not be involved in more than one reduction at once
   map<Node *, bool> seenPlaces;
-
-  PNAPI_FOREACH(p, places_)
-  {
-    seenPlaces[*p] = false;
-  }
   
   // precondition 1
-  set<Transition *> candidates = util::setIntersection(reductionCache_->singletonPresetT_,
-                                                       reductionCache_->singletonPostsetT_);
+  set<Transition *> candidates = util::setIntersection(reductionCache_->inScope(reductionCache_->singletonPresetT_),
+                                                       reductionCache_->inScope(reductionCache_->singletonPostsetT_));
   
   // iterate the transtions
   PNAPI_FOREACH(t, candidates)
@@ -2299,14 +2319,9 @@ unsigned int PetriNet::reduce_series_transitions()
   // transitions must not be involved in more than one reduction at once
   map<Node *, bool> seenTransitions;
 
-  PNAPI_FOREACH(t, transitions_)
-  {
-    seenTransitions[*t] = false;
-  }
-
   // precondition 1
-  set<Place *> candidates = util::setIntersection(reductionCache_->singletonPresetP_,
-                                                  reductionCache_->singletonPostsetP_);
+  set<Place *> candidates = util::setIntersection(reductionCache_->inScope(reductionCache_->singletonPresetP_),
+                                                  reductionCache_->inScope(reductionCache_->singletonPostsetP_));
   
   // iterate the internal places
   PNAPI_FOREACH(p, candidates) 
@@ -2442,8 +2457,7 @@ unsigned int PetriNet::reduce_self_loop_places()
   set<Place *> self_loop_places;
 
   // precondition 1
-  set<Place *> candidates = util::setIntersection(reductionCache_->singletonPresetP_,
-                                                  reductionCache_->singletonPresetP_);
+  set<Place *> candidates = reductionCache_->inScope(reductionCache_->singletonPresetP_);
   
   // find places fulfilling the preconditions
   PNAPI_FOREACH(p, candidates)
@@ -2524,8 +2538,8 @@ unsigned int PetriNet::reduce_self_loop_transitions()
   unsigned int result = 0;
 
   // precondition 1
-  set<Transition *> candidates = util::setIntersection(reductionCache_->singletonPresetT_,
-                                                       reductionCache_->singletonPostsetT_);
+  set<Transition *> candidates = util::setIntersection(reductionCache_->inScope(reductionCache_->singletonPresetT_),
+                                                       reductionCache_->inScope(reductionCache_->singletonPostsetT_));
   
   PNAPI_FOREACH(t, candidates)
   {
@@ -2831,123 +2845,141 @@ unsigned int PetriNet::reduce_equal_places()
  *                             [Murate89] will be applied.
  *          SET_STARKE       - Rules mentioned in [Sta90] will be applied.
  * 
+ *          The rules are checked in the order above until none of them
+ *          applies. Each rule is checked against the whole net at first;
+ *          afterwards, a rule is skipped as long as the net did not change
+ *          since its last check. Local rules (those with a radius) then
+ *          only check the neighbourhood of the nodes changed since, i.e.
+ *          each change of the net enqueues the nodes within the radius
+ *          for the next check of the rule.
+ *
+ *          Timing and hit counters of each rule are available by
+ *          getReductionStatistics() afterwards.
  */
 unsigned int PetriNet::reduce(unsigned int reduction_level)
 {
   // trace(TRACE_DEBUG, "[PN]\tPetri net size before simplification: " + information() + "\n");
   // trace(TRACE_INFORMATION, "Simplifying Petri net...\n");
 
-  /// initializing
-  ReductionCache cache(*this);
-  reductionCache_ = &cache;
-  
-  unsigned int done = 1;
-  unsigned int passes = 0;
-  
-  // apply reductions
-  while(done > 0)
+  /// a reduction rule
+  struct Rule
   {
-    done = 0;
-    ++passes;
+    /// the bit enabling the rule
+    unsigned int level;
+    /// the rule
+    unsigned int (PetriNet::*apply)();
+    /// name for the statistics
+    const char * name;
+    /// distance of the nodes a candidate depends on (0 if unbounded)
+    unsigned int radius;
+  };
 
+  const Rule rules[] =
+  {
 #ifdef USING_BPEL2OWFN
-    if((reduction_level & UNUSED_STATUS_PLACES) == UNUSED_STATUS_PLACES)
-    {
-      done += reduce_unused_status_places();
-    }
-    if((reduction_level & SUSPICIOS_TRANSITIONS) == SUSPICIOS_TRANSITIONS)
-    {
-      done += reduce_suspicious_transitions();
-    }
+    { UNUSED_STATUS_PLACES, &PetriNet::reduce_unused_status_places, "unused status places", 0 },
+    { SUSPICIOUS_TRANSITIONS, &PetriNet::reduce_suspicious_transitions, "suspicious transitions", 0 },
 #endif
+    { DEAD_NODES, &PetriNet::reduce_dead_nodes, "dead nodes", 1 },
+    { INITIALLY_MARKED_PLACES_IN_CHOREOGRAPHIES,
+      &PetriNet::reduce_remove_initially_marked_places_in_choreographies,
+      "initially marked places in choreographies", 0 },
+    { STARKE_RULE_3_PLACES, &PetriNet::reduce_rule_3p, "Starke rule 3 (places)", 0 },
+    { STARKE_RULE_3_TRANSITIONS, &PetriNet::reduce_rule_3t, "Starke rule 3 (transitions)", 2 },
+    { STARKE_RULE_4, &PetriNet::reduce_rule_4, "Starke rule 4", 0 },
+    { STARKE_RULE_5, &PetriNet::reduce_rule_5, "Starke rule 5", 0 },
+    { STARKE_RULE_6, &PetriNet::reduce_rule_6, "Starke rule 6", 0 },
+    { STARKE_RULE_7, &PetriNet::reduce_rule_7, "Starke rule 7", 1 },
+    { STARKE_RULE_8, &PetriNet::reduce_rule_8, "Starke rule 8", 0 },
+    { STARKE_RULE_9, &PetriNet::reduce_rule_9, "Starke rule 9", 0 },
+    { IDENTICAL_PLACES, &PetriNet::reduce_identical_places, "identical places", 2 }, // RB1
+    { IDENTICAL_TRANSITIONS, &PetriNet::reduce_identical_transitions, "identical transitions", 2 }, // RB2
+    { SERIES_PLACES, &PetriNet::reduce_series_places, "series places", 2 }, // RA1
+    { SERIES_TRANSITIONS, &PetriNet::reduce_series_transitions, "series transitions", 2 }, // RA2
+    { SELF_LOOP_PLACES, &PetriNet::reduce_self_loop_places, "self-loop places", 1 }, // RC1
+    { SELF_LOOP_TRANSITIONS, &PetriNet::reduce_self_loop_transitions, "self-loop transitions", 1 }, // RC2
+    { EQUAL_PLACES, &PetriNet::reduce_equal_places, "equal places", 0 } // RD1
+  };
 
-    if((reduction_level & DEAD_NODES) == DEAD_NODES)
-    {
-      done += reduce_dead_nodes();
-    }
-
-    if((reduction_level & INITIALLY_MARKED_PLACES_IN_CHOREOGRAPHIES) == INITIALLY_MARKED_PLACES_IN_CHOREOGRAPHIES)
-    {
-      done += reduce_remove_initially_marked_places_in_choreographies();
-    }
-
-    if((reduction_level & STARKE_RULE_3_PLACES) == STARKE_RULE_3_PLACES)
-    {
-      done += reduce_rule_3p();
-    }
-
-    if((reduction_level & STARKE_RULE_3_TRANSITIONS) == STARKE_RULE_3_TRANSITIONS)
-    {
-      done += reduce_rule_3t();
-    }
-
-    if((reduction_level & STARKE_RULE_4) == STARKE_RULE_4)
-    {
-      done += reduce_rule_4();
-    }
-
-    if((reduction_level & STARKE_RULE_5) == STARKE_RULE_5)
-    {
-      done += reduce_rule_5();
-    }
-
-    if((reduction_level & STARKE_RULE_6) == STARKE_RULE_6)
-    {
-      done += reduce_rule_6();
-    }
+  /// initializing
+  ReductionCache cache(*this);
 
-    if((reduction_level & STARKE_RULE_7) == STARKE_RULE_7)
+  // indices of the enabled rules
+  vector<unsigned int> active;
+  reductionStatistics_.clear();
+  for(unsigned int i = 0; i < (sizeof(rules) / sizeof(Rule)); ++i)
+  {
+    if((reduction_level & rules[i].level) == rules[i].level)
     {
-      done += reduce_rule_7();
-    }
+      ReductionStatistics statistics;
+      statistics.rule = rules[i].name;
+      statistics.runs = 0;
+      statistics.hits = 0;
+      statistics.seconds = 0;
 
-    if((reduction_level & STARKE_RULE_8) == STARKE_RULE_8)
-    {
-      done += reduce_rule_8();
+      active.push_back(i);
+      reductionStatistics_.push_back(statistics);
     }
+  }
 
-    if((reduction_level & STARKE_RULE_9) == STARKE_RULE_9)
+  // the number of changes and the final condition seen by the last check of each rule
+  vector<unsigned int> lastChanges(active.size(), 0);
+  vector<bool> lastTrue(active.size(), false);
+  
+  unsigned int done = 1;
+  unsigned int passes = 0;
+  
+  // apply reductions; a rule may throw, e.g. on an arc conflict, and the
+  // observer must not reach the cache on the stack afterwards
+  reductionCache_ = &cache;
+  try
+  {
+    while(done > 0)
     {
-      done += reduce_rule_9();
-    }
+      done = 0;
+      ++passes;
 
-    if((reduction_level & IDENTICAL_PLACES) == IDENTICAL_PLACES)
-    {
-      done += reduce_identical_places();  // RB1
-    }
+      for(unsigned int i = 0; i < active.size(); ++i)
+      {
+        ReductionStatistics & statistics = reductionStatistics_[i];
+        const bool isTrue = (finalCondition_ == true);
 
-    if((reduction_level & IDENTICAL_TRANSITIONS) == IDENTICAL_TRANSITIONS)
-    {
-      done += reduce_identical_transitions(); // RB2
-    }
+        // nothing changed since the last check, so the rule cannot apply
+        if((statistics.runs > 0) && (lastChanges[i] == cache.changes()) && (lastTrue[i] == isTrue))
+        {
+          continue;
+        }
 
-    if((reduction_level & SERIES_PLACES) == SERIES_PLACES)
-    {
-      done += reduce_series_places();   // RA1
-    }
+        const Rule & rule = rules[active[i]];
+        if((statistics.runs == 0) || (rule.radius == 0) || (lastTrue[i] != isTrue))
+        {
+          cache.widenScope();
+        }
+        else
+        {
+          cache.narrowScope(lastChanges[i], rule.radius);
+        }
 
-    if((reduction_level & SERIES_TRANSITIONS) == SERIES_TRANSITIONS)
-    {
-      done += reduce_series_transitions();  // RA2
-    }
+        lastChanges[i] = cache.changes();
+        lastTrue[i] = isTrue;
 
-    if((reduction_level & SELF_LOOP_PLACES) == SELF_LOOP_PLACES)
-    {
-      done += reduce_self_loop_places();  // RC1
-    }
+        clock_t start = clock();
+        unsigned int hits = (this->*(rule.apply))();
+        statistics.seconds += static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+        ++statistics.runs;
+        statistics.hits += hits;
 
-    if((reduction_level & SELF_LOOP_TRANSITIONS) == SELF_LOOP_TRANSITIONS)
-    {
-      done += reduce_self_loop_transitions(); // RC2
-    }
+        done += hits;
+      }
 
-    if((reduction_level & EQUAL_PLACES) == EQUAL_PLACES)
-    {
-      done += reduce_equal_places();    // RD1
+      if((reduction_level & ONCE) == ONCE)
+        break;
     }
-
-    if((reduction_level & ONCE) == ONCE)
-      break;
+  }
+  catch(...)
+  {
+    reductionCache_ = NULL;
+    throw;
   }
 
   /// finalizing
@@ -2956,11 +2988,23 @@ unsigned int PetriNet::reduce(unsigned int reduction_level)
   return passes;
 }
 
+/*!
+ * \brief statistics of the rules checked by the last call of reduce()
+ *
+ * For each rule enabled by the reduction level, the number of checks,
+ * the number of applications (as returned by the rule) and the time
+ * spent are given, in the order the rules are checked.
+ */
+const std::vector<PetriNet::ReductionStatistics> & PetriNet::getReductionStatistics() const
+{
+  return reductionStatistics_;
+}
+
 /*!
  * \brief constructor
  */
 PetriNet::ReductionCache::ReductionCache(PetriNet & net) :
-  net_(net)
+  net_(net), fullScope_(true)
 {
   PNAPI_FOREACH(p, net.getPlaces())
   {
@@ -3172,4 +3216,164 @@ void PetriNet::ReductionCache::removeTransition(Transition & t)
   }
 }
 
+/*!
+ * \brief record a change of a node
+ *
+ * The node (and its neighbourhood) will be checked again
+ * by local rules.
+ */
+void PetriNet::ReductionCache::touch(Node & n)
+{
+  lastChange_[&n] = changes_.size();
+  changes_.push_back(&n);
+}
+
+/*!
+ * \brief drop the recorded changes of a node about to be deleted
+ *
+ * The deletion itself still counts as a change.
+ */
+void PetriNet::ReductionCache::forget(Node & n)
+{
+  lastChange_.erase(&n);
+  changes_.push_back(NULL);
+}
+
+/*!
+ * \brief the number of changes recorded so far
+ */
+unsigned int PetriNet::ReductionCache::changes() const
+{
+  return changes_.size();
+}
+
+/*!
+ * \brief let the next rule check all nodes of the net
+ */
+void PetriNet::ReductionCache::widenScope()
+{
+  fullScope_ = true;
+  scopeP_.assign(net_.places_.begin(), net_.places_.end());
+  scopeT_.assign(net_.transitions_.begin(), net_.transitions_.end());
+}
+
+/*!
+ * \brief let the next rule check the neighbourhood of recent changes only
+ *
+ * \param since   the number of changes the rule has already seen
+ * \param radius  the distance up to which neighbours of changed nodes are checked
+ */
+void PetriNet::ReductionCache::narrowScope(unsigned int since, unsigned int radius)
+{
+  fullScope_ = false;
+
+  // the changed nodes, skipping outdated entries and deleted nodes
+  set<Node *> scope;
+  vector<Node *> border;
+  for(unsigned int i = since; i < changes_.size(); ++i)
+  {
+    map<Node *, unsigned int>::const_iterator last = lastChange_.find(changes_[i]);
+    if((last != lastChange_.end()) && (last->second == i))
+    {
+      scope.insert(changes_[i]);
+      border.push_back(changes_[i]);
+    }
+  }
+
+  // add their neighbourhood
+  for(unsigned int r = 0; r < radius; ++r)
+  {
+    vector<Node *> next;
+    PNAPI_FOREACH(n, border)
+    {
+      PNAPI_FOREACH(m, (*n)->getPreset())
+      {
+        if(scope.insert(*m).second)
+        {
+          next.push_back(*m);
+        }
+      }
+      PNAPI_FOREACH(m, (*n)->getPostset())
+      {
+        if(scope.insert(*m).second)
+        {
+          next.push_back(*m);
+        }
+      }
+    }
+    border.swap(next);
+  }
+
+  // sort by id to keep the order of the net
+  vector<pair<unsigned int, Place *> > places;
+  vector<pair<unsigned int, Transition *> > transitions;
+  PNAPI_FOREACH(n, scope)
+  {
+    Place * p = dynamic_cast<Place *>(*n);
+    if(p != NULL)
+    {
+      places.push_back(pair<unsigned int, Place *>(p->getId(), p));
+    }
+    else
+    {
+      transitions.push_back(pair<unsigned int, Transition *>((*n)->getId(), static_cast<Transition *>(*n)));
+    }
+  }
+  std::sort(places.begin(), places.end());
+  std::sort(transitions.begin(), transitions.end());
+
+  scopeP_.clear();
+  PNAPI_FOREACH(p, places)
+  {
+    scopeP_.push_back(p->second);
+  }
+  scopeT_.clear();
+  PNAPI_FOREACH(t, transitions)
+  {
+    scopeT_.push_back(t->second);
+  }
+}
+
+/*!
+ * \brief the given places within the scope
+ */
+set<Place *> PetriNet::ReductionCache::inScope(const set<Place *> & candidates) const
+{
+  if(fullScope_)
+  {
+    return candidates;
+  }
+
+  set<Place *> result;
+  PNAPI_FOREACH(p, scopeP_)
+  {
+    if(candidates.count(*p) > 0)
+    {
+      result.insert(*p);
+    }
+  }
+  return result;
+}
+
+/*!
+ * \brief the given transitions within the scope
+ */
+set<Transition *> PetriNet::ReductionCache::inScope(const set<Transition *> & candidates) const
+{
+  if(fullScope_)
+  {
+    return candidates;
+  }
+
+  set<Transition *> result;
+  PNAPI_FOREACH(t, scopeT_)
+  {
+    if(candidates.count(*t) > 0)
+    {
+      result.insert(*t);
+    }
+  }
+  return result;
+}
+
 } /* namespace pnapi */
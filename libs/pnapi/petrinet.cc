@@ -25,6 +25,9 @@
 #include "petrinet.h"
 #include "util.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 
@@ -89,6 +92,7 @@ void ComponentObserver::updateNodeNameHistory(Node & node,
   
   // remove access to nodes by their former names
   net_.nodesByName_.erase(*oldHistory.begin());
+  net_.uniqueNodeNames_.clear();
   
   try
   {
@@ -101,6 +105,20 @@ void ComponentObserver::updateNodeNameHistory(Node & node,
     
     throw e;
   }
+
+  // move the node in its typed index
+  Place * place = net_.placesByName_.find(*oldHistory.begin());
+  if (place == &node)
+  {
+    net_.placesByName_.erase(*oldHistory.begin());
+    net_.placesByName_.insert(node.getName(), place);
+  }
+  Transition * transition = net_.transitionsByName_.find(*oldHistory.begin());
+  if (transition == &node)
+  {
+    net_.transitionsByName_.erase(*oldHistory.begin());
+    net_.transitionsByName_.insert(node.getName(), transition);
+  }
 }
 
 
@@ -125,7 +143,7 @@ void ComponentObserver::initializeNodeNameHistory(Node & node)
 void ComponentObserver::updateArcCreated(Arc & arc)
 {
   PNAPI_ASSERT(&arc.getPetriNet() == &net_);
-  PNAPI_ASSERT(net_.arcs_.find(&arc) == net_.arcs_.end());
+  PNAPI_ASSERT(net_.arcs_.count(&arc) == 0);
   PNAPI_ASSERT_USER(net_.findArc(arc.getSourceNode(), arc.getTargetNode()) == NULL,
                     string("there already exists an arc between '") + arc.getSourceNode().getName()
                     + "' and '" + arc.getTargetNode().getName() + "'",
@@ -140,6 +158,13 @@ void ComponentObserver::updateArcCreated(Arc & arc)
 
   // update transition type
   arc.getTransition().updateType();
+
+  // both nodes have to be checked again by a running reduction
+  if(net_.reductionCache_ != NULL)
+  {
+    net_.reductionCache_->touch(arc.getSourceNode());
+    net_.reductionCache_->touch(arc.getTargetNode());
+  }
 }
 
 /*
@@ -150,7 +175,7 @@ void ComponentObserver::updateArcCreated(Arc & arc)
 void ComponentObserver::updateArcRemoved(Arc & arc)
 {
   PNAPI_ASSERT(&arc.getPetriNet() == &net_);
-  PNAPI_ASSERT(net_.arcs_.find(&arc) == net_.arcs_.end());
+  PNAPI_ASSERT(net_.arcs_.count(&arc) == 0);
 
   // update pre- and postsets
   arc.getTargetNode().preset_.erase(&arc.getSourceNode());
@@ -160,6 +185,13 @@ void ComponentObserver::updateArcRemoved(Arc & arc)
 
   // update transition type
   arc.getTransition().updateType();
+
+  // both nodes have to be checked again by a running reduction
+  if(net_.reductionCache_ != NULL)
+  {
+    net_.reductionCache_->touch(arc.getSourceNode());
+    net_.reductionCache_->touch(arc.getTargetNode());
+  }
 }
 
 /*
@@ -181,6 +213,7 @@ void ComponentObserver::updatePlaces(Place & place)
 {
   updateNodes(place);
   net_.places_.insert(&place);
+  net_.placesByName_.insert(place.getName(), &place);
 }
 
 /*!
@@ -190,6 +223,7 @@ void ComponentObserver::updateTransitions(Transition & trans)
 {
   updateNodes(trans);
   net_.transitions_.insert(&trans);
+  net_.transitionsByName_.insert(trans.getName(), &trans);
   updateTransitionLabels(trans);
 }
 
@@ -224,6 +258,11 @@ void ComponentObserver::updateNodes(Node & node)
 
   net_.nodes_.insert(&node);
   initializeNodeNameHistory(node);
+
+  if(net_.reductionCache_ != NULL)
+  {
+    net_.reductionCache_->touch(node);
+  }
 }
 
 } /* namespace util */
@@ -327,16 +366,14 @@ void PetriNet::clear()
   roles_.clear();
   interface_.clear();
   
-  // delete all places
-  set<Place *> places = places_;
-  PNAPI_FOREACH(it, places)
+  // delete all places; deleting leaves the iterators valid
+  PNAPI_FOREACH(it, places_)
   {
     deletePlace(**it);
   }
 
   // delete all transitions
-  set<Transition *> transitions = transitions_;
-  PNAPI_FOREACH(it, transitions)
+  PNAPI_FOREACH(it, transitions_)
   {
     deleteTransition(**it);
   }
@@ -379,7 +416,8 @@ PetriNet::copyStructure(const PetriNet & net, const std::string & prefix)
     }
   }
   
-  // add all transitions of the net
+  // add all transitions of the net, remembering the copies by id
+  vector<Transition *> transitionCopies(net.transitions_.ids(), NULL);
   PNAPI_FOREACH(it, net.transitions_)
   {
     PNAPI_ASSERT(!containsNode((*it)->getName()));
@@ -388,15 +426,30 @@ PetriNet::copyStructure(const PetriNet & net, const std::string & prefix)
     {
       t.addLabel(*labelMap[l->first], l->second);
     }
+    transitionCopies[(*it)->getId()] = &t;
   }
 
   // add all places
   const map<const Place *, const Place *> & placeMapping = copyPlaces(net, prefix);
+  vector<Place *> placeCopies(net.places_.ids(), NULL);
+  PNAPI_FOREACH(it, placeMapping)
+  {
+    placeCopies[it->first->getId()] = const_cast<Place *>(it->second);
+  }
 
-  // create arcs according to the arcs in the net
+  // create arcs between the copies of their nodes
   PNAPI_FOREACH(it, net.arcs_)
   {
-    new Arc(*this, observer_, **it);
+    Place & place = *placeCopies[(*it)->getPlace().getId()];
+    Transition & trans = *transitionCopies[(*it)->getTransition().getId()];
+    if(&(*it)->getSourceNode() == &(*it)->getPlace())
+    {
+      new Arc(*this, observer_, **it, place, trans);
+    }
+    else
+    {
+      new Arc(*this, observer_, **it, trans, place);
+    }
   }
 
   return placeMapping;
@@ -478,6 +531,11 @@ std::map<const Place *, const Place *> PetriNet::guessPlaceRelation(const PetriN
  *     step 1, an arc to this place will be created instead.  
  * 4.: Final conditions will be merged.
  * 
+ * The composition replaces this net. As nodes refer to their net and
+ * cannot be handed over to another one, it is built in a net of its own
+ * and copied into this net; use the variant with a target net to avoid
+ * this copy.
+ * 
  * \todo  review me!
  * \todo  Think about synchronous transitions!!!
  * 
@@ -485,6 +543,28 @@ std::map<const Place *, const Place *> PetriNet::guessPlaceRelation(const PetriN
 void PetriNet::compose(const PetriNet & net, const std::string & myPrefix,
                        const std::string & netPrefix)
 {
+  PetriNet result;
+  compose(net, myPrefix, netPrefix, result);
+
+  // overwrite this net with the resulting net
+  *this = result;
+}
+
+/*!
+ * \brief Compose this net to a second net into a given net.
+ *
+ * Builds the same composition as compose(const PetriNet &, const
+ * std::string &, const std::string &), but directly into the nodes of
+ * result, so the composition is never copied. Any previous content of
+ * result is discarded.
+ *
+ * \pre result is neither this net nor "net"
+ */
+void PetriNet::compose(const PetriNet & net, const std::string & myPrefix,
+                       const std::string & netPrefix, PetriNet & result) const
+{
+  PNAPI_ASSERT((&result != this) && (&result != &net));
+
   // ------------ STEP 1 -----------------------------
   
   // mapping from old interface to new interface and new places
@@ -493,365 +573,197 @@ void PetriNet::compose(const PetriNet & net, const std::string & myPrefix,
   // common synchronous labels
   set<Label *> commonLabels;
   
-  // compose interface
-  PetriNet result(interface_, net.interface_, label2label, label2place, commonLabels);
+  // compose interface into the emptied result
+  result.~PetriNet();
+  new (&result) PetriNet(interface_, net.interface_, label2label, label2place, commonLabels);
 
   // ------------ STEP 2 -----------------------------
   
-  // mapping from source nets' places to result net's places
-  map<const Place *, const Place *> placeMap;
+  // places of the resulting net, indexed by the ids of the source nets' places
+  vector<Place *> myPlaces(places_.ids(), NULL);
+  vector<Place *> netPlaces(net.places_.ids(), NULL);
 
   // copy internal places of this net
   PNAPI_FOREACH(p, places_)
   {
-    placeMap[*p] = &result.createPlace(myPrefix+(*p)->getName(), (*p)->getTokenCount());
+    myPlaces[(*p)->getId()] = &result.createPlace(myPrefix+(*p)->getName(), (*p)->getTokenCount());
   }
 
   // copy internal places of "net"
   PNAPI_FOREACH(p, net.places_)
   {
-    placeMap[*p] = &result.createPlace(netPrefix+(*p)->getName(), (*p)->getTokenCount());
+    netPlaces[(*p)->getId()] = &result.createPlace(netPrefix+(*p)->getName(), (*p)->getTokenCount());
   }
 
   // ------------ STEP 3 -----------------------------
 
-  // sets of transitions to be merged
-  set<Transition *> mergeThis;
-  set<Transition *> mergeOther;
+  // transitions to be merged, in the order of their nets
+  vector<Transition *> mergeThis;
+  vector<Transition *> mergeOther;
 
-  // iterate through this net's transitions and copy transitions
+  // iterate through this net's transitions and copy transitions without shared label
   PNAPI_FOREACH(t, transitions_)
   {
-    if( (!(*t)->isSynchronized()) || // this transition is not synchronized
-        (util::setIntersection((*t)->getSynchronousLabels(), commonLabels).empty()) ) // transition has no shared label
+    if(hasCommonLabel(**t, commonLabels))
     {
-      // create a prefixed transition in the resulting net
-      Transition & rt = result.createTransition(myPrefix+(*t)->getName());
-      rt.setCost((*t)->getCost()); // copy transition costs
-
-      // copy preset arcs
-      PNAPI_FOREACH(f, (*t)->getPresetArcs())
-      {
-        result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
-      }
-
-      // copy postset arcs
-      PNAPI_FOREACH(f, (*t)->getPostsetArcs())
-      {
-        result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-      }
-      
-      // copy labels
-      PNAPI_FOREACH(l, (*t)->getLabels())
-      {
-        Label * rl = label2label[l->first]; // label in result net
-        if(rl == NULL) // if no resulting label was found
-        {
-          // this label is now a place
-          if(l->first->getType() == Label::INPUT) // if transition was consuming
-          {
-            result.createArc(*label2place[l->first], rt, l->second);
-          }
-          else // transition was producing
-          {
-            result.createArc(rt, *label2place[l->first], l->second);
-          }
-        }
-        else
-        {
-          rt.addLabel(*rl, l->second);
-        }
-      }
+      mergeThis.push_back(*t);
     }
     else
     {
-      mergeThis.insert(*t);
+      // create a prefixed transition in the resulting net
+      Transition & rt = result.createTransition(myPrefix+(*t)->getName());
+      rt.setCost((*t)->getCost()); // copy transition costs
+      composeTransition(rt, **t, myPlaces, label2label, label2place);
     }
   }
   
-  // iterate through other net's transitions and copy transitions
+  // iterate through other net's transitions and copy transitions without shared label
   PNAPI_FOREACH(t, net.transitions_)
   {
-    if( (!(*t)->isSynchronized()) || // this transition is not synchronized
-        (util::setIntersection((*t)->getSynchronousLabels(), commonLabels).empty()) ) // transition has no shared label
+    if(hasCommonLabel(**t, commonLabels))
+    {
+      mergeOther.push_back(*t);
+    }
+    else
     {
       // create a prefixed transition in the resulting net
       Transition & rt = result.createTransition(netPrefix+(*t)->getName());
       rt.setCost((*t)->getCost()); // copy transition costs
+      composeTransition(rt, **t, netPlaces, label2label, label2place);
+    }
+  }
 
-      // copy preset arcs
-      PNAPI_FOREACH(f, (*t)->getPresetArcs())
-      {
-        result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
-      }
+  // each common label and the label of the same name in the other interface
+  map<Label *, Label *> partnerLabel;
+  PNAPI_FOREACH(l, commonLabels)
+  {
+    Label * mine = interface_.findLabel((*l)->getName());
+    partnerLabel[*l] = (mine == *l) ? net.interface_.findLabel((*l)->getName()) : mine;
+  }
 
-      // copy postset arcs
-      PNAPI_FOREACH(f, (*t)->getPostsetArcs())
+  // the transitions of "net" to be merged, bucketed by their common labels
+  map<Label *, vector<unsigned int> > bucket;
+  for(unsigned int j = 0; j < mergeOther.size(); ++j)
+  {
+    PNAPI_FOREACH(l, mergeOther[j]->getLabels())
+    {
+      if(commonLabels.count(l->first) > 0)
       {
-        result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-      }
-      
-      // copy labels
-      PNAPI_FOREACH(l, (*t)->getLabels())
-      {
-        Label * rl = label2label[l->first]; // label in result net
-        if(rl == NULL) // if no resulting label was found
-        {
-          // this label is now a place
-          if(l->first->getType() == Label::INPUT) // if transition was consuming
-          {
-            result.createArc(*label2place[l->first], rt, l->second);
-          }
-          else // transition was producing
-          {
-            result.createArc(rt, *label2place[l->first], l->second);
-          }
-        }
-        else
-        {
-          rt.addLabel(*rl, l->second);
-        }
+        bucket[l->first].push_back(j);
       }
     }
-    else
-    {
-      mergeOther.insert(*t);
-    }
   }
-  
 
   /*
    * transitions without a partner
    *  
    * Transitions of the other net are assumed as "lonely".
-   * If such a transition gets a partner, it is removed from this set.
+   * If such a transition gets a partner, it is marked as matched.
    * Own transitions are assumed as not "lonely". If such a transition
-   * remains without a partner, it is added to this set.
+   * remains without a partner, it is added to this list.
    */
-  set<Transition *> lonelyTransitions1;
-  set<Transition *> lonelyTransitions2 = mergeOther;
+  vector<Transition *> lonelyTransitions1;
+  vector<bool> matched(mergeOther.size(), false);
 
   /// transitions that must be killed
-  set<Transition *> doomedTransitions;
+  vector<Transition *> doomedTransitions;
 
   /// merge matching synchronous transitions
-  PNAPI_FOREACH(t1, mergeThis)
+  vector<unsigned int> partners;
+  vector<unsigned int> seenBy(mergeOther.size(), UINT_MAX);
+  for(unsigned int i = 0; i < mergeThis.size(); ++i)
   {
-    bool stayLonely = true; // if t1 finds a partner
-    PNAPI_FOREACH(t2, mergeOther)
-    {
-      set<string> t1Labels = (*t1)->getSynchronousLabelNames();
-      set<string> t2Labels = (*t2)->getSynchronousLabelNames();
-      set<string> t12Labels = util::setIntersection(t1Labels, t2Labels); 
+    Transition & t1 = *mergeThis[i];
 
-      if(!t12Labels.empty()) // if t1 and t2 share at least one label
+    // the transitions of "net" sharing at least one label with t1, in their order
+    partners.clear();
+    PNAPI_FOREACH(l, t1.getLabels())
+    {
+      if(commonLabels.count(l->first) == 0)
       {
-        // create new transition by merging
-        Transition & rt = result.createTransition((*t1)->getName() + netPrefix + (*t2)->getName());
-        /// TODO: maybe calculate other costs for merged transitions
-        rt.setCost((*t1)->getCost() + (*t2)->getCost()); // copy transition costs
-
-        // copy preset arcs
-        PNAPI_FOREACH(f, (*t1)->getPresetArcs())
+        continue;
+      }
+      const vector<unsigned int> & candidates = bucket[partnerLabel[l->first]];
+      PNAPI_FOREACH(j, candidates)
+      {
+        if(seenBy[*j] != i)
         {
-          result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
+          seenBy[*j] = i;
+          partners.push_back(*j);
         }
+      }
+    }
+    std::sort(partners.begin(), partners.end());
 
-        // copy postset arcs
-        PNAPI_FOREACH(f, (*t1)->getPostsetArcs())
-        {
-          result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-        }
+    PNAPI_FOREACH(j, partners)
+    {
+      Transition & t2 = *mergeOther[*j];
 
-        // copy "net"'s preset arcs
-        PNAPI_FOREACH(f, (*t2)->getPresetArcs())
-        {
-          result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
-        }
+      // create new transition by merging
+      Transition & rt = result.createTransition(t1.getName() + netPrefix + t2.getName());
+      /// TODO: maybe calculate other costs for merged transitions
+      rt.setCost(t1.getCost() + t2.getCost()); // copy transition costs
 
-        // copy "net"'s postset arcs
-        PNAPI_FOREACH(f, (*t2)->getPostsetArcs())
-        {
-          result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-        }
+      composeTransition(rt, t1, myPlaces, label2label, label2place);
+      composeTransition(rt, t2, netPlaces, label2label, label2place);
 
-        // copy labels
-        bool doomed = false;
-        PNAPI_FOREACH(l, (*t1)->getLabels())
+      // a transition holding a common label that the other one doesn't is dead
+      //TODO: partial matching may be handled differently
+      bool doomed = false;
+      PNAPI_FOREACH(l, t1.getLabels())
+      {
+        if((commonLabels.count(l->first) > 0) &&
+           (t2.getLabels().count(partnerLabel[l->first]) == 0))
         {
-          Label * rl = label2label[l->first]; // label in resulting net
-          if(rl == NULL) // label is a common label or now a place
-          {
-            Place * p = label2place[l->first]; // former interface label
-            if(p == NULL)
-            {
-              // this label is a common label
-              if(t12Labels.find(l->first->getName()) == t12Labels.end())
-              {
-                // this transition holds a common label that the other one doesn't
-                doomed = true;
-                //TODO: partial matching may be handled differently
-              }
-            }
-            else
-            {
-              if(l->first->getType() == Label::INPUT) // transition was consuming
-              {
-                result.createArc(*p, rt, l->second);
-              }
-              else // transition was producing
-              {
-                result.createArc(rt, *p, l->second);
-              }
-            }
-          }
-          else
-          {
-            rt.addLabel(*rl, l->second);
-          }
+          doomed = true;
         }
-        PNAPI_FOREACH(l, (*t2)->getLabels())
-        {
-          Label * rl = label2label[l->first]; // label in resulting net
-          if(rl == NULL) // label is a common label or now a place
-          {
-            Place * p = label2place[l->first]; // former interface label
-            if(p == NULL)
-            {
-              // this label is a common label
-              if(t12Labels.find(l->first->getName()) == t12Labels.end())
-              {
-                // this transition holds a common label that the other one doesn't
-                doomed = true;
-                //TODO: partial matching may be handled differently
-              }
-            }
-            else
-            {
-              if(l->first->getType() == Label::INPUT) // transition was consuming
-              {
-                result.createArc(*p, rt, l->second);
-              }
-              else // transition was producing
-              {
-                result.createArc(rt, *p, l->second);
-              }
-            }
-          }
-          else
-          {
-            rt.addLabel(*rl, l->second);
-          }
-        }
-        
-        if(doomed)
+      }
+      PNAPI_FOREACH(l, t2.getLabels())
+      {
+        if((commonLabels.count(l->first) > 0) &&
+           (t1.getLabels().count(partnerLabel[l->first]) == 0))
         {
-          doomedTransitions.insert(&rt);
+          doomed = true;
         }
-        
-        // both transitions found a partner
-        stayLonely = false;
-        lonelyTransitions2.erase(*t2);
       }
+      
+      if(doomed)
+      {
+        doomedTransitions.push_back(&rt);
+      }
+      
+      // both transitions found a partner
+      matched[*j] = true;
     }
-    if(stayLonely)
+
+    if(partners.empty())
     {
-      lonelyTransitions1.insert(*t1);
+      lonelyTransitions1.push_back(&t1);
     }
   }
 
   // copy lonely transitions
   PNAPI_FOREACH(t, lonelyTransitions1)
   {
-    // create new transition by merging
     Transition & rt = result.createTransition(myPrefix + (*t)->getName());
     rt.setCost((*t)->getCost()); // copy transition costs
-
-    // copy preset arcs
-    PNAPI_FOREACH(f, (*t)->getPresetArcs())
-    {
-      result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
-    }
-  
-    // copy postset arcs
-    PNAPI_FOREACH(f, (*t)->getPostsetArcs())
-    {
-      result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-    }
-
-    // copy labels
-    PNAPI_FOREACH(l, (*t)->getLabels())
-    {
-      Label * rl = label2label[l->first]; // label in resulting net
-      if(rl == NULL) // label not found in net
-      {
-        Place * p = label2place[l->first]; // maybe label is now a place
-        if(p != NULL) // yes, it is
-        {
-          if(l->first->getType() == Label::INPUT) // transition was consuming
-          {
-            result.createArc(*p, rt, l->second);
-          }
-          else // transition was producing
-          {
-            result.createArc(rt, *p, l->second);
-          }
-        }
-      }
-      else
-      {
-        rt.addLabel(*rl, l->second);
-      }
-    }
+    composeTransition(rt, **t, myPlaces, label2label, label2place);
     
     // this transition is dead
-    doomedTransitions.insert(&rt);
+    doomedTransitions.push_back(&rt);
   }
-  PNAPI_FOREACH(t, lonelyTransitions2)
+  for(unsigned int j = 0; j < mergeOther.size(); ++j)
   {
-    // create new transition by merging
-    Transition & rt = result.createTransition(netPrefix + (*t)->getName());
-    rt.setCost((*t)->getCost()); // copy transition costs
-
-    // copy preset arcs
-    PNAPI_FOREACH(f, (*t)->getPresetArcs())
-    {
-      result.createArc(*const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getSourceNode())]), rt, (*f)->getWeight());
-    }
-  
-    // copy postset arcs
-    PNAPI_FOREACH(f, (*t)->getPostsetArcs())
+    if(matched[j])
     {
-      result.createArc(rt, *const_cast<Place *>(placeMap[static_cast<Place *>(&(*f)->getTargetNode())]), (*f)->getWeight());
-    }
-
-    // copy labels
-    PNAPI_FOREACH(l, (*t)->getLabels())
-    {
-      Label * rl = label2label[l->first]; // label in resulting net
-      if(rl == NULL) // label not found in net
-      {
-        Place * p = label2place[l->first]; // maybe label is now a place
-        if(p != NULL) // yes, it is
-        {
-          if(l->first->getType() == Label::INPUT) // transition was consuming
-          {
-            result.createArc(*p, rt, l->second);
-          }
-          else // transition was producing
-          {
-            result.createArc(rt, *p, l->second);
-          }
-        }
-      }
-      else
-      {
-        rt.addLabel(*rl, l->second);
-      }
+      continue;
     }
+    Transition & rt = result.createTransition(netPrefix + mergeOther[j]->getName());
+    rt.setCost(mergeOther[j]->getCost()); // copy transition costs
+    composeTransition(rt, *mergeOther[j], netPlaces, label2label, label2place);
     
     // this transition is dead
-    doomedTransitions.insert(&rt);
+    doomedTransitions.push_back(&rt);
   }
   
 
@@ -862,12 +774,90 @@ void PetriNet::compose(const PetriNet & net, const std::string & myPrefix,
     result.createArc(p, **t);
   }
 
-  // here be dragons
+  // here be dragons: only the places of the final conditions need a mapping
+  map<const Place *, const Place *> placeMap;
+  set<const Place *> concerning = finalCondition_.concerningPlaces();
+  PNAPI_FOREACH(p, concerning)
+  {
+    placeMap[*p] = myPlaces[(*p)->getId()];
+  }
   result.finalCondition_.conjunct(finalCondition_, placeMap);
+  placeMap.clear();
+  concerning = net.finalCondition_.concerningPlaces();
+  PNAPI_FOREACH(p, concerning)
+  {
+    placeMap[*p] = netPlaces[(*p)->getId()];
+  }
   result.finalCondition_.conjunct(net.finalCondition_, placeMap);
+}
 
-  // overwrite this net with the resulting net
-  *this = result;
+
+/*!
+ * \brief copies the arcs and labels of a transition into a composed transition
+ *
+ * Arcs of the source transition are redirected to the places given by
+ * the ids of their original places. Labels are translated by the maps
+ * of the interface composition; labels that became places yield arcs,
+ * common synchronous labels are dropped.
+ */
+void PetriNet::composeTransition(Transition & rt, const Transition & t,
+                                 const std::vector<Place *> & places,
+                                 const std::map<Label *, Label *> & label2label,
+                                 const std::map<Label *, Place *> & label2place)
+{
+  PetriNet & result = rt.getPetriNet();
+
+  // copy preset arcs
+  PNAPI_FOREACH(f, t.getPresetArcs())
+  {
+    result.createArc(*places[(*f)->getPlace().getId()], rt, (*f)->getWeight());
+  }
+
+  // copy postset arcs
+  PNAPI_FOREACH(f, t.getPostsetArcs())
+  {
+    result.createArc(rt, *places[(*f)->getPlace().getId()], (*f)->getWeight());
+  }
+
+  // copy labels
+  PNAPI_FOREACH(l, t.getLabels())
+  {
+    map<Label *, Label *>::const_iterator rl = label2label.find(l->first); // label in result net
+    if(rl != label2label.end() && rl->second != NULL)
+    {
+      rt.addLabel(*rl->second, l->second);
+      continue;
+    }
+
+    map<Label *, Place *>::const_iterator p = label2place.find(l->first); // maybe label is now a place
+    if(p != label2place.end() && p->second != NULL)
+    {
+      if(l->first->getType() == Label::INPUT) // transition was consuming
+      {
+        result.createArc(*p->second, rt, l->second);
+      }
+      else // transition was producing
+      {
+        result.createArc(rt, *p->second, l->second);
+      }
+    }
+  }
+}
+
+
+/*!
+ * \brief checks whether a transition has one of the given synchronous labels
+ */
+bool PetriNet::hasCommonLabel(const Transition & t, const std::set<Label *> & commonLabels)
+{
+  PNAPI_FOREACH(l, t.getLabels())
+  {
+    if((l->first->getType() == Label::SYNCHRONOUS) && (commonLabels.count(l->first) > 0))
+    {
+      return true;
+    }
+  }
+  return false;
 }
 
 
@@ -986,15 +976,7 @@ Label & PetriNet::createSynchronizeLabel(const std::string & name, const std::st
  */
 bool PetriNet::containsNode(const Node & node) const
 {
-  PNAPI_FOREACH(n, nodes_)
-  {
-    if(*n == &node)
-    {
-      return true;
-    }
-  }
-  
-  return false;
+  return (nodes_.count(const_cast<Node *>(&node)) > 0);
 }
 
 
@@ -1029,8 +1011,21 @@ Node * PetriNet::findNode(const std::string & name) const
  */
 Place * PetriNet::findPlace(const std::string & name) const
 {
-  // if we had a map placesByName we could avoid the dynamic cast here
-  return dynamic_cast<Place *>(findNode(name));
+  return placesByName_.find(name);
+}
+
+
+/*!
+ * \brief find a place by a name given as character range
+ * 
+ * Allows scanners to look up names without building a string.
+ * 
+ * \return  a pointer to the place or a NULL pointer if the place was not
+ *          found.
+ */
+Place * PetriNet::findPlace(const char * name, size_t length) const
+{
+  return placesByName_.find(name, length);
 }
 
 
@@ -1042,8 +1037,21 @@ Place * PetriNet::findPlace(const std::string & name) const
  */
 Transition * PetriNet::findTransition(const std::string & name) const
 {
-  // if we had a map transitionsByName we could avoid the dynamic cast here
-  return dynamic_cast<Transition *>(findNode(name));
+  return transitionsByName_.find(name);
+}
+
+
+/*!
+ * \brief find a transition by a name given as character range
+ * 
+ * Allows scanners to look up names without building a string.
+ * 
+ * \return  a pointer to the transition or a NULL pointer if the transition
+ *          was not found.
+ */
+Transition * PetriNet::findTransition(const char * name, size_t length) const
+{
+  return transitionsByName_.find(name, length);
 }
 
 
@@ -1052,6 +1060,19 @@ Transition * PetriNet::findTransition(const std::string & name) const
  */
 Arc * PetriNet::findArc(const Node & source, const Node & target) const
 {
+  // scan the smaller arc set, as interface places may have huge ones
+  if(target.getPresetArcs().size() < source.getPostsetArcs().size())
+  {
+    PNAPI_FOREACH(it, target.getPresetArcs())
+    {
+      if(&((*it)->getSourceNode()) == &source)
+      {
+        return (*it);
+      }
+    }
+    return NULL;
+  }
+
   PNAPI_FOREACH(it, source.getPostsetArcs())
   {
     if(&((*it)->getTargetNode()) == &target)
@@ -1078,7 +1099,7 @@ const Interface & PetriNet::getInterface() const
 /*!
  * \brief get all nodes
  */
-const std::set<Node *> & PetriNet::getNodes() const
+const PetriNet::Nodes & PetriNet::getNodes() const
 {
   return nodes_;
 }
@@ -1087,7 +1108,7 @@ const std::set<Node *> & PetriNet::getNodes() const
 /*!
  * \brief get places
  */
-const std::set<Place *> & PetriNet::getPlaces() const
+const PetriNet::Places & PetriNet::getPlaces() const
 {
   return places_;
 }
@@ -1096,7 +1117,7 @@ const std::set<Place *> & PetriNet::getPlaces() const
 /*!
  * \brief get transitions
  */
-const std::set<Transition *> & PetriNet::getTransitions() const
+const PetriNet::Transitions & PetriNet::getTransitions() const
 {
   return transitions_;
 }
@@ -1105,7 +1126,7 @@ const std::set<Transition *> & PetriNet::getTransitions() const
 /*!
  * \brief get arcs
  */
-const std::set<Arc *> & PetriNet::getArcs() const
+const PetriNet::Arcs & PetriNet::getArcs() const
 {
   return arcs_;
 }
@@ -1171,10 +1192,11 @@ void PetriNet::addRoles(const std::set<std::string> & roles)
  */
 std::string PetriNet::getUniqueNodeName(const std::string & base) const
 {
-  int i = 0;
+  // the names up to the cached number are taken, as the cache is
+  // lowered whenever a node is deleted and reset when one is renamed
+  int & i = uniqueNodeNames_[base];
   string name;
 
-  // use a "mutable" cache to make this more efficient
   do
   {
     ostringstream str;
@@ -1183,10 +1205,38 @@ std::string PetriNet::getUniqueNodeName(const std::string & base) const
   }
   while(nodesByName_.find(name) != nodesByName_.end());
 
+  // the returned name is still free, so the next search starts with it
+  --i;
+
   return name;
 }
 
 
+/*!
+ * \brief makes the name of a deleted node available to getUniqueNodeName()
+ */
+void PetriNet::releaseUniqueNodeName(const std::string & name)
+{
+  PNAPI_FOREACH(it, uniqueNodeNames_)
+  {
+    // only names consisting of the base and a number are generated
+    const string & base = it->first;
+    if((name.size() <= base.size()) || (name.size() > base.size() + 9) ||
+       (name.compare(0, base.size(), base) != 0) || (name[base.size()] == '0') ||
+       (name.find_first_not_of("0123456789", base.size()) != string::npos))
+    {
+      continue;
+    }
+
+    const int number = atoi(name.c_str() + base.size());
+    if(number <= it->second)
+    {
+      it->second = number - 1;
+    }
+  }
+}
+
+
 /*!
  * \brief   checks whether the Petri net is free choice
  *
@@ -1638,6 +1688,8 @@ void PetriNet::deletePlace(Place & place)
   finalCondition_.removePlace(place);
   
   places_.erase(&place);
+  placesByName_.erase(place.getName());
+
   deleteNode(place);
 }
 
@@ -1651,6 +1703,7 @@ void PetriNet::deleteTransition(Transition & trans)
     synchronizedTransitions_.erase(&trans);
   }
   transitions_.erase(&trans);
+  transitionsByName_.erase(trans.getName());
 
   deleteNode(trans);
 }
@@ -1666,9 +1719,9 @@ void PetriNet::deleteNode(Node & node)
 {
   PNAPI_ASSERT(containsNode(node));
   PNAPI_ASSERT((dynamic_cast<Place *>(&node) == NULL) ? true :
-         (places_.find(dynamic_cast<Place *>(&node)) == places_.end()));
+         (places_.count(dynamic_cast<Place *>(&node)) == 0));
   PNAPI_ASSERT((dynamic_cast<Transition *>(&node) == NULL) ? true :
-         (transitions_.find(dynamic_cast<Transition *>(&node)) == transitions_.end()));
+         (transitions_.count(dynamic_cast<Transition *>(&node)) == 0));
 
   while(!node.getPreset().empty())
     deleteArc(*findArc(**node.getPreset().begin(), node));
@@ -1678,7 +1731,13 @@ void PetriNet::deleteNode(Node & node)
 
   // remove access to this nodes
   nodesByName_.erase(*node.getNameHistory().begin());
+  releaseUniqueNodeName(node.getName());
   
+  if(reductionCache_ != NULL)
+  {
+    reductionCache_->forget(node);
+  }
+
   nodes_.erase(&node);
 
   delete &node;
@@ -1692,7 +1751,7 @@ void PetriNet::deleteNode(Node & node)
  */
 void PetriNet::deleteArc(Arc & arc)
 {
-  PNAPI_ASSERT(arcs_.find(&arc) != arcs_.end());
+  PNAPI_ASSERT(arcs_.count(&arc) == 1);
 
   arcs_.erase(&arc);
 
@@ -1712,6 +1771,9 @@ void PetriNet::deleteArc(Arc & arc)
  */
 void PetriNet::normalize_classical()
 {
+  // the propositions for the final condition, added at once in the end
+  vector<const formula::Formula *> wrapped;
+
   // iterate through input labels
   set<Label *> inputs = interface_.getInputLabels();
   PNAPI_FOREACH(label, inputs)
@@ -1764,7 +1826,8 @@ void PetriNet::normalize_classical()
     // adjust complement place
     cp.setTokenCount(complementMarking);
     // adjust final condition
-    finalCondition_ = (finalCondition_.getFormula() && (np == 0) && (cp == complementMarking));  
+    wrapped.push_back(new formula::FormulaEqual(np, 0));
+    wrapped.push_back(new formula::FormulaEqual(cp, complementMarking));
   }
   
   // iterate through output places
@@ -1818,7 +1881,14 @@ void PetriNet::normalize_classical()
     // adjust complement place
     cp.setTokenCount(complementMarking);
     // adjust final condition
-    finalCondition_ = (finalCondition_.getFormula() && (np == 0) && (cp == complementMarking));
+    wrapped.push_back(new formula::FormulaEqual(np, 0));
+    wrapped.push_back(new formula::FormulaEqual(cp, complementMarking));
+  }
+
+  if(!wrapped.empty())
+  {
+    wrapped.push_back(finalCondition_.getFormula().clone());
+    finalCondition_ = formula::Conjunction(wrapped);
   }
 }
 
@@ -27,8 +27,11 @@
 #include "condition.h"
 #include "exception.h"
 #include "interface.h"
+#include "nameindex.h"
+#include "nodelist.h"
 
 #include <inttypes.h>
+#include <vector>
 
 #ifdef HAVE_STDINT_H
 // #include <stdint.h>
@@ -120,6 +123,16 @@ class PetriNet
   friend std::ostream & io::__woflan::output(std::ostream &, const PetriNet &);
 
 public: /* public types */
+  /*!
+   * \name containers of the net structure, iterated in insertion order
+   */
+  //@{
+  typedef util::NodeList<Node, util::NodeSlot> Nodes;
+  typedef util::NodeList<Place, util::IdSlot> Places;
+  typedef util::NodeList<Transition, util::IdSlot> Transitions;
+  typedef util::NodeList<Arc, util::IdSlot> Arcs;
+  //@}
+
   /*!
    * \brief determining applied reduction rules
    */
@@ -165,6 +178,21 @@ public: /* public types */
     LIVENESS = (SET_PILLAT | SET_STARKE)
   };
 
+  /*!
+   * \brief what a reduction rule achieved during reduce()
+   */
+  struct ReductionStatistics
+  {
+    /// name of the rule
+    std::string rule;
+    /// how often the rule was checked
+    unsigned int runs;
+    /// how often the rule was applied
+    unsigned int hits;
+    /// time spent in the rule in seconds
+    double seconds;
+  };
+
   /*!
    * \brief determining the Service Automaton => PetriNet Conerter
    */
@@ -210,6 +238,21 @@ private: /* private types */
     /// remove a transition from the cache
     void removeTransition(Transition &);
     
+    /// record a change of a node
+    void touch(Node &);
+    /// drop the recorded changes of a deleted node
+    void forget(Node &);
+    /// the number of recorded changes
+    unsigned int changes() const;
+    /// let the next rule check the whole net
+    void widenScope();
+    /// let the next rule check the neighbourhood of recent changes only
+    void narrowScope(unsigned int, unsigned int);
+    /// the candidates within the scope
+    std::set<Place *> inScope(const std::set<Place *> &) const;
+    /// the candidates within the scope
+    std::set<Transition *> inScope(const std::set<Transition *> &) const;
+    
     /// places with empty preset
     std::set<Place *> emptyPresetP_;
     /// transitions with empty preset
@@ -230,6 +273,17 @@ private: /* private types */
     
     /// interval of valid final place markings
     std::map<Place *, formula::Interval> intervals_;
+    
+    /// changed nodes in order of their changes
+    std::vector<Node *> changes_;
+    /// position of the last valid entry of a node in changes_
+    std::map<Node *, unsigned int> lastChange_;
+    /// whether the scope covers the whole net
+    bool fullScope_;
+    /// places to be checked by the next rule, in net order
+    std::vector<Place *> scopeP_;
+    /// transitions to be checked by the next rule, in net order
+    std::vector<Transition *> scopeT_;
   };
   
   
@@ -261,20 +315,26 @@ private: /* private variables */
    * \name (overlapping) sets for net structure
    */
   //@{
-  /// set of all nodes
-  std::set<Node *> nodes_;
+  /// all nodes
+  Nodes nodes_;
   /// all nodes indexed by name
   std::map<std::string, Node *> nodesByName_;
   /// all places
-  std::set<Place *> places_;
+  Places places_;
   /// all transitions
-  std::set<Transition *> transitions_;
+  Transitions transitions_;
+  /// all places indexed by name
+  util::NameIndex<Place> placesByName_;
+  /// all transitions indexed by name
+  util::NameIndex<Transition> transitionsByName_;
   /// all synchronized transitions
   std::set<Transition *> synchronizedTransitions_;
   /// all arcs
-  std::set<Arc *> arcs_;
+  Arcs arcs_;
   /// roles
   std::set<std::string> roles_;
+  /// for each base name, a number below which getUniqueNodeName() finds no free name
+  mutable std::map<std::string, int> uniqueNodeNames_;
   //@}
   
   /*! 
@@ -290,6 +350,8 @@ private: /* private variables */
   unsigned int warnings_;
   /// cache for reduction
   ReductionCache * reductionCache_;
+  /// statistics of the last reduction
+  std::vector<ReductionStatistics> reductionStatistics_;
   /// capacity for genet
   uint8_t genetCapacity_;
   /// converter Automaton => PetriNet
@@ -353,8 +415,12 @@ public: /* public methods */
   Node * findNode(const std::string &) const;
   /// find a place by name
   Place * findPlace(const std::string &) const;
+  /// find a place by a name given as character range
+  Place * findPlace(const char *, size_t) const;
   /// find a transition by name
   Transition * findTransition(const std::string &) const;
+  /// find a transition by a name given as character range
+  Transition * findTransition(const char *, size_t) const;
   /// find an arc by its connected nodes
   Arc * findArc(const Node &, const Node &) const;
   /// get the interface
@@ -362,15 +428,15 @@ public: /* public methods */
   /// get the interface
   const Interface & getInterface() const;
   /// get all nodes
-  const std::set<Node *> & getNodes() const;
+  const Nodes & getNodes() const;
   /// get places
-  const std::set<Place *> & getPlaces() const;
+  const Places & getPlaces() const;
   /// get transitions
-  const std::set<Transition *> & getTransitions() const;
+  const Transitions & getTransitions() const;
   /// get synchronized transitions
   const std::set<Transition *> & getSynchronizedTransitions() const;
   /// get arcs
-  const std::set<Arc *> & getArcs() const;
+  const Arcs & getArcs() const;
   /// get roles
   const std::set<std::string> & getRoles() const;
   /// get the final condition
@@ -448,10 +514,15 @@ public: /* public methods */
   /// compose two nets by adding the given one and merging interfaces
   void compose(const PetriNet &, const std::string & = "net1",
                const std::string & = "net2");
+  /// compose two nets into a third one, which is overwritten
+  void compose(const PetriNet &, const std::string &, const std::string &,
+               PetriNet &) const;
   /// normalizes the Petri net
   std::map<Transition *, std::string> normalize();
   /// applies structral reduction rules
   unsigned int reduce(unsigned int = LEVEL_5);
+  /// statistics of the rules checked by the last reduction
+  const std::vector<ReductionStatistics> & getReductionStatistics() const;
   /// product with Constraint oWFN
   void produce(const PetriNet &, const std::string & = "net",
                const std::string & = "constraint") throw (exception::InputError);
@@ -489,6 +560,13 @@ private: /* private methods */
   /// adds the places of a second net
   std::map<const Place *, const Place *>
   copyPlaces(const PetriNet &, const std::string &);
+  /// copies the arcs and labels of a transition into a composed transition
+  static void composeTransition(Transition &, const Transition &,
+                                const std::vector<Place *> &,
+                                const std::map<Label *, Label *> &,
+                                const std::map<Label *, Place *> &);
+  /// checks whether a transition has one of the given synchronous labels
+  static bool hasCommonLabel(const Transition &, const std::set<Label *> &);
 
   /// cleans up the net
   void clear();
@@ -503,6 +581,8 @@ private: /* private methods */
   //@{
   /// returns a name for a node to be added
   std::string getUniqueNodeName(const std::string &) const;
+  /// makes the name of a deleted node available to getUniqueNodeName()
+  void releaseUniqueNodeName(const std::string &);
   /// returns the meta information if available
   std::string getMetaInformation(std::ios_base &, io::MetaInformation,
                                  const std::string & = "") const;
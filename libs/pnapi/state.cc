@@ -46,11 +46,10 @@ State::State(const unsigned int name) :
 /*!
  * \brief standard constructor service automaton
  */
-State::State(Marking & m, std::map<const Place *, unsigned int> * pw,
-             unsigned int & counter) :
-  name_(counter++), isFinal_(false), isInitial_(false), m_(&m)
+State::State(Marking & m, unsigned int & counter) :
+  name_(counter++), isFinal_(false), isInitial_(false), m_(&m),
+  hashValue_(m.getHashValue())
 {
-  setHashValue(pw);
 }
 
 
@@ -211,24 +210,6 @@ unsigned int State::size() const
 }
 
 
-/*!
- * \brief set the hash value
- */
-void State::setHashValue(std::map<const Place *, unsigned int> * pw)
-{
-  if (m_ != NULL)
-  {
-    unsigned int hash = 0;
-    PNAPI_FOREACH(i, m_->getMap())
-    {
-      hash += (i->second * (*pw)[i->first]) % Automaton::HASH_SIZE;
-    }
-    
-    hashValue_ = hash % Automaton::HASH_SIZE;
-  }
-}
-
-
 /*!
  * \brief adding a state to the preset
  */
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <set>
 #include <map>
+#include <vector>
 
 namespace pnapi
 {
@@ -78,7 +79,7 @@ public: /* public methods */
   /// constructor
   State(const unsigned int);
   /// standard constructor service automaton
-  State(Marking &, std::map<const Place *, unsigned int> *, unsigned int &);
+  State(Marking &, unsigned int &);
   /// copy constructor
   State(const State &);
   /// copy a state from one automaton to another one
@@ -131,8 +132,6 @@ private: /* private functions */
   void addPostState(State &);
   /// adding an edge to the postset edges
   void addPostEdge(Edge &);
-  /// set the hash value
-  void setHashValue(std::map<const Place *, unsigned int> *);
 };
 
 
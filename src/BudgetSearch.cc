@@ -0,0 +1,107 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include "BudgetSearch.h"
+#include "MaxCost.h"
+#include "ServiceTools.h"
+#include "Tara.h"
+#include "verbose.h"
+
+BudgetSearch::BudgetSearch(unsigned int lower, unsigned int upper)
+    : lower_(lower < upper ? lower : upper), upper_(upper), probes_(0) {
+}
+
+BudgetSearch* BudgetSearch::create(unsigned int lower, unsigned int upper) {
+    return create(lower, upper, Tara::graph.costs());
+}
+
+BudgetSearch* BudgetSearch::create(unsigned int lower, unsigned int upper, const std::vector<unsigned int>& costs) {
+    switch (Tara::args_info.search_arg) {
+        case search_arg_galloping: return new Galloping(lower, upper);
+        case search_arg_interpolation: return new Interpolation(lower, upper, costs);
+        default: return new Bisection(lower, upper);
+    }
+}
+
+unsigned int BudgetSearch::search() {
+    return search(*Tara::net, *Tara::modification);
+}
+
+unsigned int BudgetSearch::search(pnapi::PetriNet& net, Modification& modification) {
+    while (lower_ < upper_) {
+        const unsigned int budget = next();
+
+        modification.setToValue(budget);
+        status("Checking budget %d (lower bound: %d, upper bound: %d)", budget, lower_, upper_);
+        ++probes_;
+
+        const bool controllable = isControllable(net, modification, true);
+        if (controllable) {
+            upper_ = budget;
+        } else {
+            lower_ = budget + 1;
+        }
+        update(budget, controllable);
+    }
+    return upper_;
+}
+
+unsigned int Bisection::next() {
+    return lower_ + (upper_ - lower_) / 2;
+}
+
+unsigned int Galloping::next() {
+    if (not galloping_) {
+        return lower_ + (upper_ - lower_) / 2;
+    }
+    // the budget step_ - 1 above the lower bound, but below the upper bound
+    return (upper_ - lower_ > step_ - 1) ? lower_ + step_ - 1 : upper_ - 1;
+}
+
+void Galloping::update(unsigned int budget, bool controllable) {
+    if (controllable) {
+        galloping_ = false;
+    } else {
+        step_ *= 2;
+    }
+}
+
+Interpolation::Interpolation(unsigned int lower, unsigned int upper, const std::vector<unsigned int>& costs)
+    : BudgetSearch(lower, upper) {
+    std::vector<unsigned long long> through;
+    cheapestFinalPaths(costs, through);
+
+    // only costs which may still be probed are kept
+    for (unsigned int s = 0; s < through.size(); ++s) {
+        if (through[s] >= lower_ and through[s] < upper_) {
+            paths_.push_back(through[s]);
+        }
+    }
+    std::sort(paths_.begin(), paths_.end());
+}
+
+unsigned int Interpolation::next() {
+    const std::vector<unsigned long long>::iterator first = std::lower_bound(paths_.begin(), paths_.end(), lower_);
+    const std::vector<unsigned long long>::iterator last = std::lower_bound(first, paths_.end(), upper_);
+    if (first == last) {
+        return lower_ + (upper_ - lower_) / 2;
+    }
+    return static_cast<unsigned int>(*(first + (last - first) / 2));
+}
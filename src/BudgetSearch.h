@@ -0,0 +1,131 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef BUDGET_SEARCH_H
+#define BUDGET_SEARCH_H
+
+#include <vector>
+#include <pnapi/pnapi.h>
+#include "Modification.h"
+
+/**
+ * @brief strategy of the search for the minimal budget
+ *
+ * Controllability is monotone in the budget: if the net is controllable
+ * under some budget, it is controllable under any higher budget. Each
+ * probe thus either lowers the upper or raises the lower bound of the
+ * interval containing the minimal budget. The strategies only differ in
+ * which budget of the interval they probe next.
+ */
+class BudgetSearch {
+public:
+    /**
+     * @brief prepares a search for the minimal budget in [lower, upper]
+     * @pre the net is controllable under budget upper
+     */
+    BudgetSearch(unsigned int lower, unsigned int upper);
+    virtual ~BudgetSearch() {};
+
+    /// creates the strategy selected on the command line
+    static BudgetSearch* create(unsigned int lower, unsigned int upper);
+
+    /// the same for the given costs of the edges of the inner graph
+    static BudgetSearch* create(unsigned int lower, unsigned int upper, const std::vector<unsigned int>& costs);
+
+    /// searches the minimal budget, probing Tara::net with Tara::modification
+    unsigned int search();
+
+    /// searches the minimal budget, probing a copy of the net with its modification
+    unsigned int search(pnapi::PetriNet& net, Modification& modification);
+
+    /// the number of probes so far
+    unsigned int probes() const { return probes_; }
+
+    /// the name of the strategy
+    virtual const char* name() const = 0;
+
+protected:
+    /// the next budget to probe; lower_ <= result < upper_
+    virtual unsigned int next() = 0;
+
+    /// informs the strategy about the result of a probe (bounds are already updated)
+    virtual void update(unsigned int budget, bool controllable) {};
+
+    /// the minimal budget lies in [lower_, upper_]
+    unsigned int lower_;
+    unsigned int upper_;
+
+    unsigned int probes_;
+};
+
+/// plain bisection of the interval
+class Bisection : public BudgetSearch {
+public:
+    Bisection(unsigned int lower, unsigned int upper) : BudgetSearch(lower, upper) {};
+    const char* name() const { return "bisection"; }
+protected:
+    unsigned int next();
+};
+
+/**
+ * @brief galloping search upwards from the lower bound
+ *
+ * Probes budgets in exponentially growing distance above the lower bound
+ * until a controllable budget is found, and bisects the last gap then. If
+ * the minimal budget is close to the lower bound, this needs far fewer
+ * probes than bisection.
+ */
+class Galloping : public BudgetSearch {
+public:
+    Galloping(unsigned int lower, unsigned int upper) : BudgetSearch(lower, upper), step_(1), galloping_(true) {};
+    const char* name() const { return "galloping"; }
+protected:
+    unsigned int next();
+    void update(unsigned int budget, bool controllable);
+private:
+    /// the distance of the next probe to the lower bound
+    unsigned int step_;
+    /// false once a controllable budget was found
+    bool galloping_;
+};
+
+/**
+ * @brief interpolation search
+ *
+ * Estimates where controllability changes from the costs of the cheapest
+ * final paths through the states of the inner graph: a budget below these
+ * costs cuts a state off, so the budgets at which states are cut off are
+ * the likely positions of the minimal budget. The next probe is the median
+ * of the costs within the interval, so each probe halves the states whose
+ * costs are still in question rather than the budgets. Beyond the costs of
+ * all states, the interval is bisected.
+ */
+class Interpolation : public BudgetSearch {
+public:
+    /// prepares the search with the costs of the edges of the inner graph
+    Interpolation(unsigned int lower, unsigned int upper, const std::vector<unsigned int>& costs);
+    const char* name() const { return "interpolation"; }
+protected:
+    unsigned int next();
+private:
+    /// the sorted costs of the cheapest final paths through the states
+    std::vector<unsigned long long> paths_;
+};
+
+#endif
@@ -2,48 +2,100 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
 #include "tinythread.h"
+#include "ServiceTools.h"
 #include "verbose.h"
 
 #include <stdio.h>
 #include <vector>
 #include <time.h>
 
-/// little help struct
-struct bruch {
-    int z;
-    int n;
-};
-
-volatile unsigned int CCSearch::upper=0;
-volatile unsigned int CCSearch::lower=0;
+unsigned int CCSearch::upper=0;
+unsigned int CCSearch::lower=0;
+std::map<unsigned int, CCSearch::Probe> CCSearch::inFlight;
+tthread::mutex CCSearch::mutex;
+tthread::condition_variable CCSearch::changed;
 
 void CCSearch::setBounds(unsigned int newLower,unsigned int newUpper) {
-    upper=newUpper; lower=newLower;
+    upper=newUpper; lower=newLower < newUpper ? newLower : newUpper;
 }
 
-void CCSearch::threadFunction(void* args) {
+unsigned int CCSearch::nextBudget() {
+    // find the largest gap between lower-1, the probed budgets and upper
+    unsigned int bestFrom = 0;
+    unsigned int bestSize = 0;
+    unsigned int from = lower;
+    for(std::map<unsigned int, Probe>::iterator it=inFlight.lower_bound(lower); it!=inFlight.end() && it->first<upper; ++it) {
+        if(it->first-from > bestSize) {
+            bestFrom=from;
+            bestSize=it->first-from;
+        }
+        from=it->first+1;
+    }
+    if(upper-from > bestSize) {
+        bestFrom=from;
+        bestSize=upper-from;
+    }
 
+    // every budget of the interval is being probed
+    if(bestSize==0) {
+        return upper;
+    }
+    return bestFrom+(bestSize-1)/2;
+}
+
+void CCSearch::killObsoleteProbes() {
+    for(std::map<unsigned int, Probe>::iterator it=inFlight.begin(); it!=inFlight.end(); ++it) {
+        if((it->first<lower || it->first>=upper) && !it->second.obsolete) {
+            it->second.obsolete=true;
+            if(it->second.pid>0) {
+                status("CCSearch: stopping obsolete check of budget %d", it->first);
+                kill(-it->second.pid, SIGTERM);
+            }
+        }
+    }
+}
+
+void CCSearch::threadFunction(void* args) {
     // thread may be called only this way,
     // otherwise seg-fault
-    bruch* b=(bruch*) args;
-    int zaehler=b->z;
-    int nenner=b->n;
-    while(abs(upper-lower)>0) {
-        unsigned int t=(lower)+zaehler*((upper)-(lower))/nenner;
-        bool lessEq=isLessEq(t);
-        // here it is important, that upper and lower are volatile
-        // otherwise caching would cause pain in the ass
-        if(lessEq && upper>t) upper=t;
-        if(!lessEq && lower<=t) lower=t+1;
-
-        status("CCSearch: new bounds: %d and %d \n", lower,upper);
-        // maybe nothing happens, if another thread found a better bound faster
+    Worker* worker=(Worker*) args;
+
+    tthread::lock_guard<tthread::mutex> lock(mutex);
+    while(lower<upper) {
+        unsigned int t=nextBudget();
+        if(t==upper) {
+            // wait for a probe to finish
+            changed.wait(mutex);
+            continue;
+        }
+
+        Probe probe={0,false};
+        inFlight[t]=probe;
+
+        mutex.unlock();
+        bool lessEq;
+        bool valid=isLessEq(*worker, t, lessEq);
+        mutex.lock();
+
+        // only probes stopped as obsolete come back without a result
+        inFlight.erase(t);
+        if(valid) {
+            // results are valid even for obsolete probes, as
+            // controllability is monotone in the budget
+            if(lessEq && upper>t) upper=t;
+            if(!lessEq && lower<=t) lower=t+1;
+            status("CCSearch: new bounds: %d and %d", lower,upper);
+            killObsoleteProbes();
+        }
+        changed.notify_all();
     }
 }
 
@@ -59,68 +111,63 @@ unsigned int CCSearch::search() {
     // if the number may not be defined, use 1..
     if(prozesse==0) prozesse=1;
 
-    status("CCSearch: #threads: %d \n", prozesse);
+    status("CCSearch: #threads: %d", prozesse);
+
+    // killed wendys must not take us down when we write to them
+    signal(SIGPIPE, SIG_IGN);
 
-    // TODO: set this value by a command line parameter
+    // select the backend before the workers share it
+    ControllabilityBackend::get();
 
-    //create the processes and assign them their fract
+    // each worker gets its own copy of the modified net
+    std::vector<Worker> workers(prozesse);
     std::vector<tthread::thread*> pv(prozesse);
-    for(unsigned int i=1;i<=prozesse;++i) {
-        bruch* b=new bruch();
-        b->z=i;
-        b->n=prozesse+1;
-        pv[i-1]= new tthread::thread(&CCSearch::threadFunction,b);
+    for(unsigned int i=0;i<prozesse;++i) {
+        workers[i].net=new pnapi::PetriNet(*Tara::net);
+        workers[i].modification=Tara::modification->clone(workers[i].net);
     }
-    // wait for all processes to be ready...
-    for(std::vector<tthread::thread*>::iterator it=pv.begin();it!=pv.end();++it) {
-        (*it)->join();
+    for(unsigned int i=0;i<prozesse;++i) {
+        pv[i]= new tthread::thread(&CCSearch::threadFunction,&workers[i]);
     }
 
-    // this should never ever happen
-    if(upper!=lower)
-        printf("concurrent search failed, no exact result... oh crap ");
-    
-    return lower;
-}
-
-// BEGIN: most of this should be in service tools file
+    // wait for all processes to be ready...
+    for(unsigned int i=0;i<prozesse;++i) {
+        pv[i]->join();
+        delete pv[i];
+        delete workers[i].modification;
+        delete workers[i].net;
+    }
 
-/// check if a file exists and can be opened for reading
-inline bool fileExists(const std::string& filename) {
-    std::ifstream tmp(filename.c_str(), std::ios_base::in);
-    return tmp.good();
+    return upper;
 }
-bool CCSearch::isLessEq(unsigned int x) {
-    static tthread::mutex m;
-
-    //only one may change the net, so lock the mutex
-    m.lock();
-    Tara::modification->setToValue(x);
 
-    std::stringstream ss("");
-    ss << pnapi::io::owfn << (*Tara::net) << std::flush;
-
-    // next one may mod the net...
-    m.unlock();
-   
-    std::string tempFile=Output().name();
-    std::string wendyCommand("wendy --correctness=livelock ");
-    wendyCommand+= " --waitstatesOnly --receivingBeforeSending --seqReceivingEvents   --succeedingSendingEvent  --quitAsSoonAsPossible ";
-    wendyCommand+=" --sa="+tempFile;
-
-    // call wendy and open a pipe
-    FILE* fp = popen(wendyCommand.c_str(), "w");
-
-    // send the net to wendy
-    fprintf(fp, "%s", ss.str().c_str());
+/// a probe is stopped as soon as its budget leaves the interval
+class CCSearch::ProbeCheck : public StoppableCheck {
+    public:
+        explicit ProbeCheck(unsigned int budget) : budget(budget) {}
+
+        bool started(pid_t pid) {
+            tthread::lock_guard<tthread::mutex> lock(mutex);
+            if(inFlight[budget].obsolete) {
+                return false;
+            }
+            inFlight[budget].pid=pid;
+            return true;
+        }
+
+        bool stopped() {
+            tthread::lock_guard<tthread::mutex> lock(mutex);
+            return inFlight[budget].obsolete;
+        }
+
+    private:
+        unsigned int budget;
+};
 
-    // close the pipe
-    pclose(fp);
+bool CCSearch::isLessEq(Worker& worker, unsigned int x, bool& lessEq) {
+    // only this worker modifies its net
+    worker.modification->setToValue(x);
 
-    if(!fileExists(tempFile)) {
-       return false;
-    }
-    return true;
+    ProbeCheck probe(x);
+    return checkControllability(*worker.net, worker.modification, true, lessEq, &probe);
 }
-
-// END OF: this should be in serviceTools.cc
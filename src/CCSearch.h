@@ -1,14 +1,14 @@
-
 #ifndef CCSEARCH_H
 #define CCSEARCH_H
 
 #include <stdio.h>
 #include "Tara.h"
 #include <stdlib.h>
-#include <pthread.h>
+#include <sys/types.h>
 #include "tinythread.h"
+#include <map>
 #include <vector>
-#include "iModification.h"
+#include "Modification.h"
 
 /** 
  * Concurrent Search
@@ -16,27 +16,68 @@
  * Tries to use several threads for wendy checks
  * for better runtime on multi-core archtitectures
  * 
- * The idea of the algorithm is to advance the binary search to
- * k-ary search...
+ * A pool of workers probes budgets of the interval [lower, upper] that
+ * still contains the minimal budget. Each worker owns a copy of the
+ * modified net, so nets are modified and serialized concurrently. A
+ * worker always picks the middle of the largest gap between the budgets
+ * probed at the moment, so no budget is probed twice. As soon as a
+ * result moves a bound, the wendy processes of all probes outside the
+ * new interval are killed.
  *
  * */
 class CCSearch {
     private:
+        /// a budget being probed
+        struct Probe {
+            /// the process group of wendy, 0 if not yet started
+            pid_t pid;
+            /// set if the budget left the interval
+            bool obsolete;
+        };
+
+        /// a worker with its private copy of the modified net
+        struct Worker {
+            pnapi::PetriNet* net;
+            Modification* modification;
+        };
+
+        class ProbeCheck;
+
         /// this function is run by each thread
         static void threadFunction(void* args);
-        /** compare to the value, that is search,
-         */
-        static bool isLessEq(unsigned int x);
+
+        /// the budget to probe next or the upper bound if all are in flight
+        static unsigned int nextBudget();
+
+        /// checks whether the worker's net is controllable under budget x
+        /// (result is false if the probe got obsolete and was killed; other
+        /// failures of wendy abort)
+        static bool isLessEq(Worker& worker, unsigned int x, bool& lessEq);
+
+        /// kills the probes outside the current interval
+        static void killObsoleteProbes();
+
+        /// the budgets being probed, guarded by mutex
+        static std::map<unsigned int, Probe> inFlight;
+
+        /// guards bounds and probes
+        static tthread::mutex mutex;
+
+        /// signalled whenever bounds or probes change
+        static tthread::condition_variable changed;
+
     public:
         // constructor
         static void setBounds(unsigned int lowerBound, unsigned int upperBound);
+
         // search the highes value, which satisfies the predicate "isLessEq(.)"
         static unsigned int search();
-        /// the upper bound
-        static volatile unsigned int upper;
-        /// lower bound
-        static volatile unsigned int lower;
 
+        /// the upper bound, guarded by mutex
+        static unsigned int upper;
+
+        /// lower bound, guarded by mutex
+        static unsigned int lower;
 };
 
 #endif // include guard
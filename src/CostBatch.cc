@@ -0,0 +1,167 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+#include "CostBatch.h"
+#include "BudgetSearch.h"
+#include "MaxCost.h"
+#include "ServiceTools.h"
+#include "Tara.h"
+#include "iModification.h"
+#include "verbose.h"
+
+std::vector<CostBatch::Job> CostBatch::jobs;
+unsigned int CostBatch::nextJob = 0;
+tthread::mutex CostBatch::mutex;
+
+bool CostBatch::requested() {
+    return Tara::args_info.costfunction_given > 1 or Tara::args_info.seeds_given;
+}
+
+void CostBatch::parse() {
+    unsigned int seed = Tara::args_info.randomseed_given ? Tara::args_info.randomseed_arg : time(NULL);
+    const unsigned int perRandom = Tara::args_info.seeds_given ? Tara::args_info.seeds_arg : 1;
+
+    for (unsigned int i = 0; i < Tara::args_info.costfunction_given; ++i) {
+        const char* filename = Tara::args_info.costfunction_arg[i];
+        const bool random = strcmp(filename, "-r") == 0;
+
+        for (unsigned int k = 0; k < (random ? perRandom : 1); ++k) {
+            // the parser fills the cost function of Tara, which is handed over to the job
+            Tara::partialCostFunction.clear();
+            std::stringstream name;
+            if (random) {
+                name << "-r (seed " << seed << ")";
+                Tara::randomCostFunction(seed++);
+            } else {
+                name << filename;
+                Parser::costfunction.parse(filename);
+            }
+
+            jobs.push_back(Job());
+            jobs.back().name = name.str();
+            jobs.back().costs.swap(Tara::partialCostFunction);
+        }
+    }
+
+    // the inner graph is built without costs
+    Tara::partialCostFunction.clear();
+    Tara::highestTransitionCosts = 0;
+
+    // reset transitions change the net depending on the costs
+    if (not Tara::resetMap.empty()) {
+        abort(7, "reset transitions cannot be combined with several cost functions");
+    }
+    status("parsed %d cost functions", jobs.size());
+}
+
+void CostBatch::evaluate(unsigned int threads) {
+    // select the backend before the workers share it
+    ControllabilityBackend::get();
+
+    threads = threads < jobs.size() ? threads : jobs.size();
+    status("evaluating %d cost functions with %d threads", jobs.size(), threads);
+
+    std::vector<tthread::thread*> pv(threads);
+    for (unsigned int i = 0; i < threads; ++i) {
+        pv[i] = new tthread::thread(&CostBatch::threadFunction, NULL);
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        pv[i]->join();
+        delete pv[i];
+    }
+}
+
+void CostBatch::threadFunction(void* args) {
+    while (true) {
+        unsigned int job;
+        {
+            tthread::lock_guard<tthread::mutex> lock(mutex);
+            if (nextJob == jobs.size()) {
+                return;
+            }
+            job = nextJob++;
+        }
+        evaluate(jobs[job]);
+    }
+}
+
+void CostBatch::evaluate(Job& job) {
+    std::vector<unsigned int> costs;
+    Tara::graph.costs(job.costs, costs);
+
+    // the same bounds as the scc heuristics, or maxout if this is better
+    bool exact;
+    const unsigned int sccBound = sccUpperBound(costs, exact);
+    const unsigned int maxoutBound = Tara::graph.sumOfLocalMaxCosts(costs);
+    job.upper = sccBound < maxoutBound ? sccBound : maxoutBound;
+    job.lower = minimalCost(costs);
+    job.budget = job.upper;
+    job.probes = 0;
+
+    // the copy of the net is modified with the costs of its own transitions
+    pnapi::PetriNet* net;
+    {
+        tthread::lock_guard<tthread::mutex> lock(mutex);
+        net = new pnapi::PetriNet(*Tara::net);
+    }
+    std::map<pnapi::Transition*, unsigned int> netCosts;
+    for (std::map<pnapi::Transition*, unsigned int>::const_iterator it = job.costs.begin(); it != job.costs.end(); ++it) {
+        pnapi::Transition* t = net->findTransition(it->first->getName());
+        if (t != NULL) {
+            netCosts[t] = it->second;
+        }
+    }
+
+    {
+        iModification modification(net, netCosts);
+        modification.init(job.upper);
+
+        job.bounded = isControllable(*net, modification, true);
+        if (job.bounded and job.upper > 0) {
+            BudgetSearch* budgetSearch = BudgetSearch::create(job.lower, job.upper, costs);
+            job.budget = budgetSearch->search(*net, modification);
+            job.probes = budgetSearch->probes();
+            delete budgetSearch;
+        }
+    }
+    delete net;
+
+    status("%s: minimal budget %d", job.name.c_str(), job.budget);
+}
+
+void CostBatch::print(FILE* file) {
+    size_t width = strlen("cost function");
+    for (unsigned int i = 0; i < jobs.size(); ++i) {
+        width = jobs[i].name.size() > width ? jobs[i].name.size() : width;
+    }
+
+    fprintf(file, "%-*s %12s %12s %12s %8s\n", static_cast<int>(width), "cost function", "lower bound", "upper bound", "budget", "checks");
+    for (unsigned int i = 0; i < jobs.size(); ++i) {
+        const Job& job = jobs[i];
+        if (job.bounded) {
+            fprintf(file, "%-*s %12u %12u %12u %8u\n", static_cast<int>(width), job.name.c_str(), job.lower, job.upper, job.budget, job.probes);
+        } else {
+            fprintf(file, "%-*s %12u %12u %12s %8u\n", static_cast<int>(width), job.name.c_str(), job.lower, job.upper, "unbounded", job.probes);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef COST_BATCH_H
+#define COST_BATCH_H
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+#include "tinythread.h"
+
+/**
+ * @brief evaluates several cost functions against one inner graph
+ *
+ * The inner graph does not depend on the costs: it is built once, with the
+ * transitions of its edges and their parallel transitions, and every cost
+ * function given on the command line is applied to it in turn. Each
+ * evaluation computes the edge costs, the bounds and the minimal budget of
+ * one cost function. As the evaluations are independent, several of them
+ * run in parallel, each on its own copy of the net with a modification of
+ * its own. The results are printed as one table in the order of the
+ * command line.
+ */
+class CostBatch {
+    public:
+        /// whether several cost functions were given on the command line
+        static bool requested();
+
+        /// parses or generates all cost functions given on the command line
+        static void parse();
+
+        /// the number of cost functions
+        static unsigned int size() { return jobs.size(); }
+
+        /// evaluates all cost functions against Tara::graph with the given number of threads
+        static void evaluate(unsigned int threads);
+
+        /// prints the results as a table
+        static void print(FILE* file);
+
+    private:
+        /// a cost function and the results of its evaluation
+        struct Job {
+            /// the file name or the seed of the cost function
+            std::string name;
+            /// the costs of the transitions of Tara::net
+            std::map<pnapi::Transition*, unsigned int> costs;
+            unsigned int lower;
+            unsigned int upper;
+            /// false if the net is not controllable under the upper bound
+            bool bounded;
+            unsigned int budget;
+            /// the number of budgets checked by the search
+            unsigned int probes;
+        };
+
+        /// this function is run by each thread
+        static void threadFunction(void* args);
+
+        /// computes the bounds and the minimal budget of one cost function
+        static void evaluate(Job& job);
+
+        /// the cost functions in the order of the command line
+        static std::vector<Job> jobs;
+
+        /// the next cost function to evaluate, guarded by mutex
+        static unsigned int nextJob;
+
+        /// guards nextJob and copying Tara::net
+        static tthread::mutex mutex;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <map>
+#include <string>
+#include <sstream>
+#include "CostReduction.h"
+#include "Tara.h"
+
+namespace CostReduction {
+    void reduceComposition(pnapi::PetriNet& composition) {
+
+        // each level includes the rules of the previous ones; rules which
+        // remove dead nodes or fire transitions would lose final states or costs
+        unsigned int level = pnapi::PetriNet::SERIES_PLACES | pnapi::PetriNet::SERIES_TRANSITIONS;
+        if (Tara::args_info.reduce_arg != reduce_arg_series) {
+            level |= pnapi::PetriNet::IDENTICAL_PLACES | pnapi::PetriNet::IDENTICAL_TRANSITIONS;
+        }
+        if (Tara::args_info.reduce_arg == reduce_arg_parallel) {
+            level |= pnapi::PetriNet::STARKE_RULE_3_PLACES | pnapi::PetriNet::STARKE_RULE_3_TRANSITIONS;
+        }
+
+        // a state is final if it satisfies the final condition of Tara::net,
+        // whatever the partner's places are marked with; the places of the
+        // net keep their names in the composition
+        {
+            std::map<const pnapi::Place*, const pnapi::Place*> places;
+            const pnapi::PetriNet::Places& netPlaces = Tara::net->getPlaces();
+            for (pnapi::PetriNet::Places::const_iterator p = netPlaces.begin(); p != netPlaces.end(); ++p) {
+                places[*p] = composition.findPlace((*p)->getName());
+            }
+            pnapi::formula::Formula* finalCondition = Tara::net->getFinalCondition().getFormula().clone(&places);
+            composition.getFinalCondition() = *finalCondition;
+            delete finalCondition;
+        }
+
+        // every cost is attached to its transitions as an output label; the
+        // rules only fuse transitions if at most one of them is labeled and
+        // only merge alternatives with equal labels, so the labels of a
+        // reduced transition sum up the costs of the transitions it replaces
+        std::map<unsigned int, pnapi::Label*> labels;
+        std::map<std::string, unsigned int> values;
+        {
+            pnapi::Port& port = composition.getInterface().addPort("tara-costs");
+            const pnapi::PetriNet::Transitions& transitions = composition.getTransitions();
+            for (pnapi::PetriNet::Transitions::const_iterator t = transitions.begin(); t != transitions.end(); ++t) {
+                const unsigned int cost = Tara::cost(Tara::net->findTransition((*t)->getName()));
+                if (cost == 0) {
+                    continue;
+                }
+                if (labels.find(cost) == labels.end()) {
+                    std::stringstream name;
+                    name << "tara-cost-" << cost;
+                    labels[cost] = &composition.getInterface().addOutputLabel(name.str(), port);
+                    values[name.str()] = cost;
+                }
+                (*t)->addLabel(*labels[cost]);
+            }
+        }
+
+        std::stringstream before;
+        before << pnapi::io::stat << composition;
+
+        // a rule may fail halfway, e.g. on an arc conflict, and leave the
+        // composition broken; its labeled copy is explored instead then
+        pnapi::PetriNet unreduced(composition);
+        try {
+            composition.reduce(level);
+
+            std::stringstream after;
+            after << pnapi::io::stat << composition;
+            status("reduced composition %s to %s", before.str().c_str(), after.str().c_str());
+        } catch (pnapi::exception::Error error) {
+            std::stringstream reductionerror;
+            reductionerror << error;
+            message("could not reduce the composition, pnapi error %s", reductionerror.str().c_str());
+            composition = unreduced;
+        }
+
+        // the labels are ignored by LoLA, so they may stay in the net
+        const pnapi::PetriNet::Transitions& transitions = composition.getTransitions();
+        for (pnapi::PetriNet::Transitions::const_iterator t = transitions.begin(); t != transitions.end(); ++t) {
+            unsigned int cost = 0;
+            const std::map<pnapi::Label*, unsigned int>& costLabels = (*t)->getLabels();
+            for (std::map<pnapi::Label*, unsigned int>::const_iterator l = costLabels.begin(); l != costLabels.end(); ++l) {
+                cost += values[l->first->getName()] * l->second;
+            }
+            if (cost > 0) {
+                Tara::reducedCostFunction[*t] = cost;
+            }
+        }
+        Tara::reducedNet = &composition;
+    }
+}
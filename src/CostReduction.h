@@ -0,0 +1,38 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef COST_REDUCTION_H
+#define COST_REDUCTION_H
+
+#include <pnapi/pnapi.h>
+#include "verbose.h"
+
+namespace CostReduction {
+    /**
+     * @brief reduces the composition of Tara::net and its most-permissive
+     * partner with the rules of the level given by --reduce
+     *
+     * Only rules which keep the costs of the paths to final states are
+     * applied. Afterwards, Tara::reducedNet points to the composition and
+     * Tara::reducedCostFunction holds the costs of its transitions.
+     */
+    void reduceComposition(pnapi::PetriNet& composition);
+}
+
+#endif
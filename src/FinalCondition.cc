@@ -0,0 +1,135 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include "FinalCondition.h"
+
+using namespace pnapi::formula;
+
+FinalCondition::FinalCondition(const pnapi::PetriNet& net) : net_(net) {
+    // number the places densely in the order of the net
+    const pnapi::PetriNet::Places& places = net.getPlaces();
+    for (pnapi::PetriNet::Places::const_iterator p = places.begin(); p != places.end(); ++p) {
+        if ((*p)->getId() >= number_.size()) {
+            number_.resize((*p)->getId() + 1, NO_PLACE);
+        }
+        number_[(*p)->getId()] = names_.size();
+        names_.push_back((*p)->getName());
+    }
+
+    compile(net.getFinalCondition().getFormula());
+}
+
+unsigned int FinalCondition::findPlace(const char* name, size_t length) const {
+    const pnapi::Place* place = net_.findPlace(name, length);
+    return place != NULL ? number(*place) : NO_PLACE;
+}
+
+void FinalCondition::compile(const Formula& formula) {
+    Instruction instruction = { LOAD_TRUE, 0, 0 };
+
+    switch (formula.getType()) {
+        case Formula::F_TRUE:
+            instruction.operation = LOAD_TRUE;
+            break;
+        case Formula::F_FALSE:
+            instruction.operation = LOAD_FALSE;
+            break;
+
+        case Formula::F_NEGATION:
+            compile(**static_cast<const Operator&>(formula).getChildren().begin());
+            instruction.operation = NEGATE;
+            break;
+
+        case Formula::F_CONJUNCTION:
+        case Formula::F_DISJUNCTION: {
+            const std::set<const Formula*>& children = static_cast<const Operator&>(formula).getChildren();
+            const bool conjunction = (formula.getType() == Formula::F_CONJUNCTION);
+
+            // the empty conjunction is true, the empty disjunction false
+            if (children.empty()) {
+                instruction.operation = conjunction ? LOAD_TRUE : LOAD_FALSE;
+                break;
+            }
+
+            // evaluate the children one by one and leave as soon as the result is clear
+            std::vector<unsigned int> jumps;
+            for (std::set<const Formula*>::const_iterator child = children.begin(); child != children.end(); ++child) {
+                compile(**child);
+                jumps.push_back(program_.size());
+                instruction.operation = conjunction ? JUMP_IF_FALSE : JUMP_IF_TRUE;
+                program_.push_back(instruction);
+            }
+
+            // the last jump is not needed; all others jump behind the children
+            program_.pop_back();
+            jumps.pop_back();
+            for (unsigned int i = 0; i < jumps.size(); ++i) {
+                program_[jumps[i]].tokens = program_.size();
+            }
+            return;
+        }
+
+        default: {
+            const Proposition& proposition = static_cast<const Proposition&>(formula);
+            instruction.place = number(proposition.getPlace());
+            instruction.tokens = proposition.getTokens();
+
+            switch (formula.getType()) {
+                case Formula::F_EQUAL: instruction.operation = EQUAL; break;
+                case Formula::F_NOT_EQUAL: instruction.operation = NOT_EQUAL; break;
+                case Formula::F_GREATER: instruction.operation = GREATER; break;
+                case Formula::F_GREATER_EQUAL: instruction.operation = GREATER_EQUAL; break;
+                case Formula::F_LESS: instruction.operation = LESS; break;
+                default: instruction.operation = LESS_EQUAL; break;
+            }
+        }
+    }
+
+    program_.push_back(instruction);
+}
+
+bool FinalCondition::isSatisfied(const std::vector<unsigned int>& marking) const {
+    return isSatisfied(marking.empty() ? 0 : &marking[0]);
+}
+
+bool FinalCondition::isSatisfied(const unsigned int* marking) const {
+    bool result = true;
+
+    for (unsigned int pc = 0; pc < program_.size(); ++pc) {
+        const Instruction& instruction = program_[pc];
+        switch (instruction.operation) {
+            case LOAD_TRUE: result = true; break;
+            case LOAD_FALSE: result = false; break;
+            case EQUAL: result = (marking[instruction.place] == instruction.tokens); break;
+            case NOT_EQUAL: result = (marking[instruction.place] != instruction.tokens); break;
+            case GREATER: result = (marking[instruction.place] > instruction.tokens); break;
+            case GREATER_EQUAL: result = (marking[instruction.place] >= instruction.tokens); break;
+            case LESS: result = (marking[instruction.place] < instruction.tokens); break;
+            case LESS_EQUAL: result = (marking[instruction.place] <= instruction.tokens); break;
+            case NEGATE: result = not result; break;
+
+            // a jump leads to the instruction behind the target, which is
+            // why pc is set one before it
+            case JUMP_IF_FALSE: if (not result) pc = instruction.tokens - 1; break;
+            case JUMP_IF_TRUE: if (result) pc = instruction.tokens - 1; break;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef FINAL_CONDITION_H
+#define FINAL_CONDITION_H
+
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+
+/**
+ * @brief the final condition of a net, compiled into a flat program
+ *
+ * The places of the net are numbered densely, so a marking is a vector of
+ * token counts indexed by place number. The formula tree of the final
+ * condition is translated once into a sequence of comparisons and
+ * conditional jumps, which isSatisfied() runs on such a vector without any
+ * virtual calls or map lookups.
+ */
+class FinalCondition {
+public:
+    /// returned by findPlace for names which are no place of the net
+    static const unsigned int NO_PLACE = UINT_MAX;
+
+    /// compiles the final condition of the given net
+    explicit FinalCondition(const pnapi::PetriNet& net);
+
+    /// the number of places, i.e. the size of a marking vector
+    unsigned int places() const { return names_.size(); }
+
+    /// the name of the place with the given number
+    const std::string& name(unsigned int place) const { return names_[place]; }
+
+    /// the number of the place with the given name or NO_PLACE
+    unsigned int findPlace(const char* name, size_t length) const;
+
+    /// the number of a place of the net
+    unsigned int number(const pnapi::Place& place) const { return number_[place.getId()]; }
+
+    /// evaluates the final condition under a marking indexed by place numbers
+    bool isSatisfied(const std::vector<unsigned int>& marking) const;
+
+    /// evaluates the final condition under a marking of places() token counts
+    bool isSatisfied(const unsigned int* marking) const;
+
+private:
+    /// the operations of the compiled program
+    enum Operation {
+        LOAD_TRUE,
+        LOAD_FALSE,
+        EQUAL,
+        NOT_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        NEGATE,
+        JUMP_IF_FALSE,
+        JUMP_IF_TRUE
+    };
+
+    /// an instruction: comparisons read place and tokens, jumps use tokens as target
+    struct Instruction {
+        Operation operation;
+        unsigned int place;
+        unsigned int tokens;
+    };
+
+    /// translates a formula into instructions
+    void compile(const pnapi::formula::Formula& formula);
+
+    /// the net, whose name index is used to look up places
+    const pnapi::PetriNet& net_;
+
+    /// the compiled program
+    std::vector<Instruction> program_;
+
+    /// the place names, indexed by place number
+    std::vector<std::string> names_;
+
+    /// the place numbers, indexed by the ids of the places in the net
+    std::vector<unsigned int> number_;
+};
+
+#endif
@@ -0,0 +1,509 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "GraphScanner.h"
+#include "Tara.h"
+#include "tinythread.h"
+#include "verbose.h"
+
+/// displacements tried for a bucket before the table is enlarged
+static const unsigned int MAX_SEED = 1 << 12;
+
+/// files are only split into chunks of at least this many bytes
+static const size_t MIN_CHUNK = 1 << 20;
+
+/// whether c may occur in a name or number, as in the flex scanner
+static inline bool isNameChar(char c) {
+    switch (c) {
+        case ',': case ';': case ':': case '(': case ')':
+        case ' ': case '\t': case '\r': case '\n': case '{': case '}':
+            return false;
+        default:
+            return true;
+    }
+}
+
+static inline const char* skipSpace(const char* p, const char* end) {
+    while (p != end and (*p == ' ' or *p == '\t' or *p == '\r' or *p == '\n')) {
+        ++p;
+    }
+    return p;
+}
+
+static inline const char* skipWord(const char* p, const char* end) {
+    while (p != end and isNameChar(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+static inline bool isNumber(const char* word, const char* end) {
+    if (word == end) {
+        return false;
+    }
+    for (; word != end; ++word) {
+        if (*word < '0' or *word > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// whether the word [word, end) is the given keyword directly followed by a colon
+static inline bool isKeyword(const char* word, const char* end, const char* fileEnd, const char* keyword) {
+    const size_t length = strlen(keyword);
+    return static_cast<size_t>(end - word) == length and memcmp(word, keyword, length) == 0
+           and end != fileEnd and *end == ':';
+}
+
+__attribute__((noreturn)) static void scanError(const char* p, const char* end, const char* msg) {
+    const char* line = p;
+    while (line != end and *line != '\n' and line - p < 40) {
+        ++line;
+    }
+    status("error near '%.*s': %s", static_cast<int>(line - p), p, msg);
+    abort(6, "error while parsing the reachability graph");
+}
+
+/// reads a number after optional white space and moves p behind it
+static inline unsigned int scanNumber(const char*& p, const char* end) {
+    p = skipSpace(p, end);
+    const char* word = p;
+    p = skipWord(p, end);
+    if (not isNumber(word, p)) {
+        scanError(word, end, "number expected");
+    }
+    unsigned int result = 0;
+    for (; word != p; ++word) {
+        result = 10 * result + (*word - '0');
+    }
+    return result;
+}
+
+
+GraphScanner::GraphScanner(const pnapi::PetriNet& net)
+    : finalCondition_(net), slotMask_(0), bucketMask_(0), lolaToTara_(Tara::graph) {
+    std::vector<Entry> entries;
+    Entry entry = { 0, 0, FinalCondition::NO_PLACE, NULL };
+
+    for (unsigned int p = 0; p < finalCondition_.places(); ++p) {
+        const std::string& name = finalCondition_.name(p);
+        entry.offset = names_.size();
+        entry.length = name.size();
+        entry.place = p;
+        names_.insert(names_.end(), name.begin(), name.end());
+        entries.push_back(entry);
+    }
+    entry.place = FinalCondition::NO_PLACE;
+    const pnapi::PetriNet::Transitions& transitions = net.getTransitions();
+    for (pnapi::PetriNet::Transitions::const_iterator t = transitions.begin(); t != transitions.end(); ++t) {
+        const std::string& name = (*t)->getName();
+        entry.offset = names_.size();
+        entry.length = name.size();
+        entry.transition = *t;
+        names_.insert(names_.end(), name.begin(), name.end());
+        entries.push_back(entry);
+    }
+
+    // about four names per bucket and at most half of the slots used; a
+    // table for which some bucket finds no displacement is enlarged
+    unsigned int buckets = 1;
+    while (4 * buckets < entries.size()) {
+        buckets *= 2;
+    }
+    unsigned int slots = 2;
+    while (slots < 2 * entries.size()) {
+        slots *= 2;
+    }
+    bucketMask_ = buckets - 1;
+    slotMask_ = slots - 1;
+    while (not build(entries)) {
+        slotMask_ = 2 * slotMask_ + 1;
+    }
+}
+
+
+/// two FNV-1a style hashes with different primes in one pass
+void GraphScanner::hash(const char* name, unsigned int length, unsigned int& bucket, unsigned int& slot) {
+    bucket = 2166136261u;
+    slot = 0x9747b28cu;
+    for (const char* end = name + length; name != end; ++name) {
+        bucket = (bucket ^ static_cast<unsigned char>(*name)) * 16777619u;
+        slot = (slot ^ static_cast<unsigned char>(*name)) * 0x5bd1e995u;
+        slot ^= slot >> 15;
+    }
+}
+
+unsigned int GraphScanner::slot(unsigned int hash, unsigned int seed) const {
+    unsigned int x = hash + seed * 0x9e3779b9u;
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    return x & slotMask_;
+}
+
+bool GraphScanner::build(const std::vector<Entry>& entries) {
+    const Entry empty = { 0, 0, FinalCondition::NO_PLACE, NULL };
+    table_.assign(slotMask_ + 1, empty);
+    seeds_.assign(bucketMask_ + 1, 0);
+
+    // distribute the names to the buckets
+    std::vector<std::vector<unsigned int> > members(bucketMask_ + 1);
+    std::vector<unsigned int> slotHash(entries.size());
+    size_t largest = 0;
+    for (unsigned int i = 0; i < entries.size(); ++i) {
+        unsigned int bucket;
+        hash(&names_[entries[i].offset], entries[i].length, bucket, slotHash[i]);
+        members[bucket & bucketMask_].push_back(i);
+        largest = std::max(largest, members[bucket & bucketMask_].size());
+    }
+
+    // place the largest buckets first, while most slots are free
+    std::vector<unsigned int> taken;
+    for (size_t size = largest; size > 0; --size) {
+        for (unsigned int b = 0; b <= bucketMask_; ++b) {
+            if (members[b].size() != size) {
+                continue;
+            }
+
+            unsigned int seed = 0;
+            for (;; ++seed) {
+                if (seed == MAX_SEED) {
+                    return false;
+                }
+                taken.clear();
+                for (unsigned int m = 0; m < size; ++m) {
+                    const unsigned int s = slot(slotHash[members[b][m]], seed);
+                    if (table_[s].length != 0 or std::find(taken.begin(), taken.end(), s) != taken.end()) {
+                        break;
+                    }
+                    taken.push_back(s);
+                }
+                if (taken.size() == size) {
+                    break;
+                }
+            }
+
+            seeds_[b] = seed;
+            for (unsigned int m = 0; m < size; ++m) {
+                table_[taken[m]] = entries[members[b][m]];
+            }
+        }
+    }
+    return true;
+}
+
+const GraphScanner::Entry* GraphScanner::find(const char* name, unsigned int length) const {
+    unsigned int bucket, slotHash;
+    hash(name, length, bucket, slotHash);
+    const Entry& entry = table_[slot(slotHash, seeds_[bucket & bucketMask_])];
+    if (entry.length == length and memcmp(&names_[entry.offset], name, length) == 0) {
+        return &entry;
+    }
+    return NULL;
+}
+
+/// fills Tara::graph while the states are scanned
+class GraphScanner::GraphSink {
+public:
+    explicit GraphSink(GraphScanner& scanner) : scanner_(scanner), state_(0) {}
+
+    void state(unsigned int lolaState) {
+        state_ = scanner_.lolaToTara_.state(lolaState);
+        if (lolaState == 0) {
+            Tara::initialState = state_;
+        }
+    }
+
+    void final(bool isFinal) { Tara::graph.setFinal(state_, isFinal); }
+
+    void edge(unsigned int target, pnapi::Transition* transition) {
+        // parallel edges are merged by the graph, keeping the highest costs
+        Tara::graph.addEdge(state_, scanner_.lolaToTara_.state(target), transition, Tara::cost(transition));
+    }
+
+private:
+    GraphScanner& scanner_;
+    unsigned int state_;
+};
+
+/// the states of a part of the file, kept with the numbers LoLA gave them
+struct GraphScanner::Chunk {
+    const char* begin;
+    const char* end;
+
+    /// per state: its number, whether it is final, and one behind its last edge
+    std::vector<unsigned int> states;
+    std::vector<bool> finals;
+    std::vector<unsigned int> edgesEnd;
+
+    /// per edge: the number of the target, the transition and its costs
+    std::vector<unsigned int> targets;
+    std::vector<pnapi::Transition*> transitions;
+    std::vector<unsigned int> costs;
+
+    void state(unsigned int lolaState) {
+        states.push_back(lolaState);
+        finals.push_back(false);
+        edgesEnd.push_back(targets.size());
+    }
+
+    void final(bool isFinal) { finals.back() = isFinal; }
+
+    void edge(unsigned int target, pnapi::Transition* transition) {
+        targets.push_back(target);
+        transitions.push_back(transition);
+        costs.push_back(Tara::cost(transition));
+        ++edgesEnd.back();
+    }
+
+    /// frees the buffers once the chunk is merged
+    void release() {
+        std::vector<unsigned int>().swap(states);
+        std::vector<bool>().swap(finals);
+        std::vector<unsigned int>().swap(edgesEnd);
+        std::vector<unsigned int>().swap(targets);
+        std::vector<pnapi::Transition*>().swap(transitions);
+        std::vector<unsigned int>().swap(costs);
+    }
+};
+
+/// the chunks of a parallel scan, handed out to the threads one by one
+struct GraphScanner::ChunkQueue {
+    const GraphScanner* scanner;
+    std::vector<Chunk>* chunks;
+    unsigned int next;
+    tthread::mutex mutex;
+};
+
+template <class Sink>
+bool GraphScanner::scanStates(const char* p, const char* end, Sink& sink) const {
+    // the marking of the current state, indexed by place number
+    std::vector<unsigned int> marking(finalCondition_.places(), 0);
+    std::vector<unsigned int> markedPlaces;
+    bool inState = false;
+    unsigned int lolaState = 0;
+
+    for (;;) {
+        p = skipSpace(p, end);
+        if (p == end or (p + 5 <= end and memcmp(p, "STATE", 5) == 0 and (p + 5 == end or not isNameChar(p[5])))) {
+            // the marking of the previous state is complete
+            if (inState) {
+                sink.final(finalCondition_.isSatisfied(marking));
+                for (unsigned int i = 0; i < markedPlaces.size(); ++i) {
+                    marking[markedPlaces[i]] = 0;
+                }
+                markedPlaces.clear();
+            }
+            if (p == end) {
+                return inState;
+            }
+
+            p += 5;
+            lolaState = scanNumber(p, end);
+            sink.state(lolaState);
+            inState = true;
+
+            // the lowlink and the members of the SCC are not needed
+            const char* word = skipSpace(p, end);
+            const char* wordEnd = skipWord(word, end);
+            if (isKeyword(word, wordEnd, end, "Lowlink")) {
+                p = wordEnd + 1;
+                scanNumber(p, end);
+                word = skipSpace(p, end);
+                wordEnd = skipWord(word, end);
+            }
+            if (isKeyword(word, wordEnd, end, "SCC")) {
+                p = wordEnd + 1;
+                for (;;) {
+                    word = skipSpace(p, end);
+                    wordEnd = skipWord(word, end);
+                    if (not isNumber(word, wordEnd)) {
+                        break;
+                    }
+                    p = wordEnd;
+                }
+            }
+            continue;
+        }
+
+        const char* name = p;
+        p = skipWord(p, end);
+        if (p == name) {
+            scanError(name, end, "syntax error");
+        }
+        const unsigned int length = p - name;
+
+        if (not inState) {
+            // LoLA may report the size of the formula before the states
+            if (length == 7 and memcmp(name, "Formula", 7) == 0) {
+                p = static_cast<const char*>(memchr(p, '.', end - p));
+                if (p == NULL) {
+                    scanError(name, end, "syntax error");
+                }
+                ++p;
+                continue;
+            }
+            scanError(name, end, "syntax error");
+        }
+
+        p = skipSpace(p, end);
+        if (p != end and *p == ':') {
+            // a token count; places of the partner are skipped
+            ++p;
+            const unsigned int tokens = scanNumber(p, end);
+            const Entry* entry = find(name, length);
+            if (entry != NULL and entry->place != FinalCondition::NO_PLACE) {
+                marking[entry->place] = tokens;
+                markedPlaces.push_back(entry->place);
+            }
+            p = skipSpace(p, end);
+            if (p != end and *p == ',') {
+                ++p;
+            }
+        } else if (end - p >= 2 and p[0] == '-' and p[1] == '>') {
+            // an edge; self loops are not needed
+            p += 2;
+            const unsigned int target = scanNumber(p, end);
+            if (target != lolaState) {
+                const Entry* entry = find(name, length);
+                sink.edge(target, (entry != NULL) ? entry->transition : NULL);
+            }
+        } else {
+            scanError(name, end, "syntax error");
+        }
+    }
+}
+
+void GraphScanner::scanChunks(void* arguments) {
+    ChunkQueue& queue = *static_cast<ChunkQueue*>(arguments);
+    for (;;) {
+        unsigned int next;
+        {
+            tthread::lock_guard<tthread::mutex> lock(queue.mutex);
+            next = queue.next++;
+        }
+        if (next >= queue.chunks->size()) {
+            return;
+        }
+        Chunk& chunk = (*queue.chunks)[next];
+        queue.scanner->scanStates(chunk.begin, chunk.end, chunk);
+    }
+}
+
+void GraphScanner::merge(const Chunk& chunk) {
+    unsigned int edge = 0;
+    for (unsigned int i = 0; i < chunk.states.size(); ++i) {
+        const unsigned int state = lolaToTara_.state(chunk.states[i]);
+        if (chunk.states[i] == 0) {
+            Tara::initialState = state;
+        }
+        for (; edge < chunk.edgesEnd[i]; ++edge) {
+            Tara::graph.addEdge(state, lolaToTara_.state(chunk.targets[edge]), chunk.transitions[edge], chunk.costs[edge]);
+        }
+        Tara::graph.setFinal(state, chunk.finals[i]);
+    }
+}
+
+void GraphScanner::scan(const std::string& filename, unsigned int threads) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 or fstat(fd, &info) != 0) {
+        abort(6, "could not open the reachability graph '%s'", filename.c_str());
+    }
+    if (info.st_size == 0) {
+        abort(6, "the reachability graph '%s' is empty", filename.c_str());
+    }
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        abort(6, "could not map the reachability graph '%s'", filename.c_str());
+    }
+
+    const char* const begin = static_cast<const char*>(data);
+    const char* const end = begin + info.st_size;
+    bool states = false;
+
+    if (threads <= 1 or static_cast<size_t>(info.st_size) < MIN_CHUNK) {
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+        GraphSink sink(*this);
+        states = scanStates(begin, end, sink);
+    } else {
+        // split the file at lines starting with STATE into a few chunks per
+        // thread, so threads which finish early take over the remaining ones
+        std::vector<Chunk> chunks;
+        const size_t chunkSize = std::max(static_cast<size_t>(info.st_size) / (4 * threads), MIN_CHUNK);
+        const char* chunkBegin = begin;
+        while (chunkBegin != end) {
+            const char* chunkEnd = end;
+            for (const char* p = chunkBegin + std::min(chunkSize, static_cast<size_t>(end - chunkBegin)); p != end; ++p) {
+                p = static_cast<const char*>(memchr(p, '\n', end - p));
+                if (p == NULL) {
+                    break;
+                }
+                // a line starting with STATE, but not with a name like STATE_x
+                if (end - p > 5 and memcmp(p + 1, "STATE", 5) == 0 and (p + 6 == end or not isNameChar(p[6]))) {
+                    chunkEnd = p + 1;
+                    break;
+                }
+            }
+            chunks.push_back(Chunk());
+            chunks.back().begin = chunkBegin;
+            chunks.back().end = chunkEnd;
+            chunkBegin = chunkEnd;
+        }
+        status("scanning the reachability graph in %d chunks with %d threads", chunks.size(), threads);
+
+        ChunkQueue queue;
+        queue.scanner = this;
+        queue.chunks = &chunks;
+        queue.next = 0;
+        std::vector<tthread::thread*> workers(threads);
+        for (unsigned int i = 0; i < threads; ++i) {
+            workers[i] = new tthread::thread(&GraphScanner::scanChunks, &queue);
+        }
+        for (unsigned int i = 0; i < threads; ++i) {
+            workers[i]->join();
+            delete workers[i];
+        }
+
+        // number the states in the order of the file, as a sequential scan does
+        for (unsigned int i = 0; i < chunks.size(); ++i) {
+            merge(chunks[i]);
+            states = states or not chunks[i].states.empty();
+            chunks[i].release();
+        }
+    }
+
+    munmap(data, info.st_size);
+    close(fd);
+
+    if (not states) {
+        abort(6, "error while parsing the reachability graph");
+    }
+
+    // build the offset array once all states are known
+    Tara::graph.finalize();
+    Tara::sumOfLocalMaxCosts = Tara::graph.sumOfLocalMaxCosts();
+}
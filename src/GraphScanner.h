@@ -0,0 +1,115 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef GRAPH_SCANNER_H
+#define GRAPH_SCANNER_H
+
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+#include "FinalCondition.h"
+#include "LolaStateMap.h"
+
+/**
+ * @brief reads a state space written by LoLA into Tara::graph
+ *
+ * This is the counterpart of the flex/bison parser for files: the file is
+ * mapped into memory and scanned in place, and every name is resolved by a
+ * perfect hash over the places and transitions of the net which is built
+ * before scanning. Thus no token is copied, and nothing is allocated per
+ * token. The input has the form
+ *
+ *   STATE n [Lowlink: n] [SCC: n ...] place : n, ..., place : n
+ *   transition -> n
+ *   ...
+ *
+ * where names which are no place or transition of the net, e.g. places of
+ * the partner, are accepted and ignored.
+ */
+class GraphScanner {
+public:
+    /// builds the name table of the given net
+    explicit GraphScanner(const pnapi::PetriNet& net);
+
+    /**
+     * @brief reads the state space in the given file into Tara::graph
+     *
+     * With more than one thread, the file is split into chunks at the lines
+     * starting with STATE. The chunks are scanned in parallel into buffers
+     * which keep the state numbers of LoLA, and these are mapped to the
+     * states of Tara::graph when the buffers are merged in the order of the
+     * file. The graph is thus the same as the one of a sequential scan.
+     */
+    void scan(const std::string& filename, unsigned int threads = 1);
+
+private:
+    /// a place or transition in the name table; empty slots have length 0
+    struct Entry {
+        unsigned int offset;
+        unsigned int length;
+        unsigned int place;
+        pnapi::Transition* transition;
+    };
+
+    /// the compiled final condition, which also numbers the places
+    FinalCondition finalCondition_;
+
+    /// the names of all entries, one after the other
+    std::vector<char> names_;
+
+    /// the slots of the perfect hash
+    std::vector<Entry> table_;
+
+    /// the displacement of each bucket of names
+    std::vector<unsigned int> seeds_;
+
+    unsigned int slotMask_;
+    unsigned int bucketMask_;
+
+    /// maps the state numbers of LoLA to states of Tara::graph
+    LolaStateMap lolaToTara_;
+
+    /// the two hash values of a name: one selects the bucket, one the slot
+    static void hash(const char* name, unsigned int length, unsigned int& bucket, unsigned int& slot);
+
+    /// the slot of a name with the given hash value under a displacement
+    unsigned int slot(unsigned int hash, unsigned int seed) const;
+
+    /// tries to place the names in slots, fails if some bucket cannot be placed
+    bool build(const std::vector<Entry>& entries);
+
+    class GraphSink;
+    struct Chunk;
+    struct ChunkQueue;
+
+    /// the entry of the given name or NULL
+    const Entry* find(const char* name, unsigned int length) const;
+
+    /// scans the states in [p, end) into the sink; false if there are none
+    template <class Sink>
+    bool scanStates(const char* p, const char* end, Sink& sink) const;
+
+    /// scans chunks of the queue until all are taken; run by each thread
+    static void scanChunks(void* queue);
+
+    /// adds the states and edges of a scanned chunk to Tara::graph
+    void merge(const Chunk& chunk);
+};
+
+#endif
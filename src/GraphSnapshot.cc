@@ -0,0 +1,259 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "GraphSnapshot.h"
+#include "Tara.h"
+#include "VerdictCache.h"
+#include "verbose.h"
+
+/// the fixed size part at the beginning of a snapshot
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t states;
+    uint32_t edges;
+    uint32_t initial;
+    uint32_t transitions;
+    uint32_t nameBytes;
+    uint32_t parallel;
+    uint32_t reserved;
+    char net[16];
+};
+
+static const char MAGIC[8] = { 'T', 'A', 'R', 'A', 'G', 'R', 'P', 'H' };
+
+/// the index of edges which are labeled with no transition of the net
+static const uint32_t NO_TRANSITION = UINT32_MAX;
+
+/// the number of 32 bit words for the given number of bytes
+static inline size_t words(size_t bytes) {
+    return (bytes + 3) / 4;
+}
+
+/// the number of 32 bit words after the header
+static size_t payload(const SnapshotHeader& header) {
+    return (header.transitions + 1) + words(header.nameBytes)
+           + (header.states + 1) + 2 * static_cast<size_t>(header.edges)
+           + 2 * static_cast<size_t>(header.parallel) + words((header.states + 7) / 8);
+}
+
+static inline void write(std::ofstream& file, const std::vector<uint32_t>& v) {
+    if (not v.empty()) {
+        file.write(reinterpret_cast<const char*>(&v[0]), v.size() * sizeof(uint32_t));
+    }
+}
+
+/// the hash of the net as stored in the header
+static void netHash(char (&result)[16]) {
+    const std::string hash = VerdictCache::hash(*Tara::net);
+    memset(result, 0, sizeof(result));
+    memcpy(result, hash.data(), std::min(hash.size(), sizeof(result)));
+}
+
+
+void GraphSnapshot::save(const std::string& filename) {
+    const InnerGraph& graph = Tara::graph;
+
+    // number the transitions in the order they are met
+    std::map<pnapi::Transition*, uint32_t> index;
+    std::vector<uint32_t> nameOffset(1, 0);
+    std::string names;
+    std::vector<uint32_t> transition(graph.edges());
+    std::vector<std::pair<uint32_t, uint32_t> > parallel(graph.parallelTransitions());
+    for (unsigned int i = 0; i < graph.edges() + graph.parallelTransitions(); ++i) {
+        pnapi::Transition* const t = (i < graph.edges()) ? graph.transition(i) : graph.parallelTransition(i - graph.edges());
+        uint32_t id = NO_TRANSITION;
+        if (t != NULL) {
+            std::map<pnapi::Transition*, uint32_t>::iterator it = index.find(t);
+            if (it == index.end()) {
+                it = index.insert(std::make_pair(t, static_cast<uint32_t>(index.size()))).first;
+                names += t->getName();
+                nameOffset.push_back(names.size());
+            }
+            id = it->second;
+        }
+        if (i < graph.edges()) {
+            transition[i] = id;
+        } else {
+            parallel[i - graph.edges()] = std::make_pair(graph.parallelEdge(i - graph.edges()), id);
+        }
+    }
+    std::sort(parallel.begin(), parallel.end());
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.states = graph.size();
+    header.edges = graph.edges();
+    header.initial = Tara::initialState;
+    header.transitions = index.size();
+    header.nameBytes = names.size();
+    header.parallel = parallel.size();
+    netHash(header.net);
+
+    std::vector<uint32_t> offset(graph.size() + 1);
+    std::vector<uint32_t> successor(graph.edges());
+    std::vector<uint32_t> parallelEdge(parallel.size());
+    std::vector<uint32_t> parallelTransition(parallel.size());
+    std::vector<uint32_t> finals(words((graph.size() + 7) / 8), 0);
+    for (unsigned int s = 0; s < graph.size(); ++s) {
+        offset[s] = graph.firstEdge(s);
+        if (graph.isFinal(s)) {
+            finals[s / 32] |= 1u << (s % 32);
+        }
+    }
+    offset[graph.size()] = graph.edges();
+    for (unsigned int e = 0; e < graph.edges(); ++e) {
+        successor[e] = graph.successor(e);
+    }
+    for (unsigned int i = 0; i < parallel.size(); ++i) {
+        parallelEdge[i] = parallel[i].first;
+        parallelTransition[i] = parallel[i].second;
+    }
+    names.resize(4 * words(names.size()), '\0');
+
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write(file, nameOffset);
+    file.write(names.data(), names.size());
+    write(file, offset);
+    write(file, successor);
+    write(file, transition);
+    write(file, parallelEdge);
+    write(file, parallelTransition);
+    write(file, finals);
+    file.close();
+    if (not file) {
+        abort(11, "could not write to file '%s'", filename.c_str());
+    }
+
+    status("saved the inner graph to '%s'", filename.c_str());
+}
+
+
+void GraphSnapshot::load(const std::string& filename) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 or fstat(fd, &info) != 0) {
+        abort(6, "could not open the saved inner graph '%s'", filename.c_str());
+    }
+    if (static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+        abort(6, "'%s' is no saved inner graph", filename.c_str());
+    }
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        abort(6, "could not map the saved inner graph '%s'", filename.c_str());
+    }
+
+    const SnapshotHeader& header = *static_cast<const SnapshotHeader*>(data);
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        abort(6, "'%s' is no saved inner graph", filename.c_str());
+    }
+    if (header.version != FORMAT_VERSION) {
+        abort(6, "the inner graph '%s' has version %d, expected %d", filename.c_str(), header.version, FORMAT_VERSION);
+    }
+    char net[16];
+    netHash(net);
+    if (memcmp(header.net, net, sizeof(net)) != 0) {
+        abort(6, "the inner graph '%s' was saved for another net", filename.c_str());
+    }
+    if (static_cast<size_t>(info.st_size) != sizeof(SnapshotHeader) + 4 * payload(header)) {
+        abort(6, "the inner graph '%s' is truncated", filename.c_str());
+    }
+
+    const uint32_t* const nameOffset = reinterpret_cast<const uint32_t*>(&header + 1);
+    const char* const names = reinterpret_cast<const char*>(nameOffset + header.transitions + 1);
+    const uint32_t* const offset = reinterpret_cast<const uint32_t*>(names) + words(header.nameBytes);
+    const uint32_t* const successor = offset + header.states + 1;
+    const uint32_t* const transition = successor + header.edges;
+    const uint32_t* const parallelEdge = transition + header.edges;
+    const uint32_t* const parallelTransition = parallelEdge + header.parallel;
+    const uint32_t* const finals = parallelTransition + header.parallel;
+
+    // the names must lie within the name bytes, in order
+    if (header.initial >= header.states or nameOffset[header.transitions] > header.nameBytes) {
+        abort(6, "the inner graph '%s' is corrupt", filename.c_str());
+    }
+    for (unsigned int i = 0; i < header.transitions; ++i) {
+        if (nameOffset[i] > nameOffset[i + 1]) {
+            abort(6, "the inner graph '%s' is corrupt", filename.c_str());
+        }
+    }
+
+    // resolve the transitions against the net
+    std::vector<pnapi::Transition*> transitions(header.transitions);
+    for (unsigned int i = 0; i < header.transitions; ++i) {
+        const char* name = names + nameOffset[i];
+        const size_t length = nameOffset[i + 1] - nameOffset[i];
+        transitions[i] = Tara::net->findTransition(name, length);
+        if (transitions[i] == NULL) {
+            abort(6, "transition '%.*s' of the inner graph '%s' is no transition of the net",
+                  static_cast<int>(length), name, filename.c_str());
+        }
+    }
+
+    // add the edges as the parser does, so parallel edges are merged
+    // under the current cost function
+    for (unsigned int s = 0; s < header.states; ++s) {
+        Tara::graph.addState();
+    }
+    unsigned int p = 0;
+    for (unsigned int s = 0; s < header.states; ++s) {
+        if (offset[s] > offset[s + 1] or offset[s + 1] > header.edges) {
+            abort(6, "the inner graph '%s' is corrupt", filename.c_str());
+        }
+        for (unsigned int e = offset[s]; e < offset[s + 1]; ++e) {
+            if (successor[e] >= header.states
+                or (transition[e] != NO_TRANSITION and transition[e] >= header.transitions)) {
+                abort(6, "the inner graph '%s' is corrupt", filename.c_str());
+            }
+            pnapi::Transition* t = (transition[e] == NO_TRANSITION) ? NULL : transitions[transition[e]];
+            Tara::graph.addEdge(s, successor[e], t, Tara::cost(t));
+            for (; p < header.parallel and parallelEdge[p] == e; ++p) {
+                if (parallelTransition[p] != NO_TRANSITION and parallelTransition[p] >= header.transitions) {
+                    abort(6, "the inner graph '%s' is corrupt", filename.c_str());
+                }
+                t = (parallelTransition[p] == NO_TRANSITION) ? NULL : transitions[parallelTransition[p]];
+                Tara::graph.addEdge(s, successor[e], t, Tara::cost(t));
+            }
+        }
+        Tara::graph.setFinal(s, (finals[s / 32] >> (s % 32)) & 1);
+    }
+    Tara::initialState = header.initial;
+
+    munmap(data, info.st_size);
+    close(fd);
+
+    Tara::graph.finalize();
+    Tara::sumOfLocalMaxCosts = Tara::graph.sumOfLocalMaxCosts();
+
+    status("loaded the inner graph from '%s'", filename.c_str());
+}
@@ -0,0 +1,59 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <string>
+
+/**
+ * @brief binary snapshots of the inner graph
+ *
+ * A snapshot stores Tara::graph without its costs, so a later run on the
+ * same net can apply another cost function without computing the partner,
+ * the composition and the state space again. The file consists of a header
+ * and arrays of 32 bit numbers in the byte order of the machine, laid out
+ * to be read straight from a memory mapping:
+ *
+ *   header       magic, version, sizes, initial state, hash of the net
+ *   names        offsets and characters of the transitions of the edges
+ *   offsets      first edge of each state (states + 1 entries)
+ *   successors   target state of each edge
+ *   transitions  index of the name of each edge's transition, or none
+ *   parallel     edges and transitions of merged parallel edges
+ *   finals       bitset of the final states
+ *
+ * The names are resolved against Tara::net on loading, and the costs of
+ * the edges are taken from the current cost function. The hash of the net
+ * is the one of VerdictCache::hash, so a snapshot is only loaded for the
+ * net it was saved for.
+ */
+class GraphSnapshot {
+public:
+    /// the version written; snapshots of other versions are rejected
+    static const unsigned int FORMAT_VERSION = 1;
+
+    /// writes Tara::graph, which was built for Tara::net, to the given file
+    static void save(const std::string& filename);
+
+    /// reads the graph in the given file into Tara::graph
+    static void load(const std::string& filename);
+};
+
+#endif
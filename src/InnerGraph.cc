@@ -0,0 +1,198 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include "InnerGraph.h"
+
+InnerGraph::InnerGraph() : keepParallel_(false), finalized_(false) {
+    offset_.push_back(0);
+}
+
+unsigned int InnerGraph::addState() {
+    unsigned int state = final_.size();
+    final_.push_back(false);
+    inStack_.push_back(false);
+    finalized_ = false;
+    return state;
+}
+
+void InnerGraph::addEdge(unsigned int state, unsigned int successor,
+                         pnapi::Transition* transition, unsigned int costs) {
+
+    // edges of a new state start a new block
+    if (blockState_.empty() or blockState_.back() != state) {
+        blockState_.push_back(state);
+        blockStart_.push_back(successor_.size());
+    }
+
+    // merge parallel edges within the current block
+    if (successor >= lastEdgeTo_.size()) {
+        lastEdgeTo_.resize(successor >= size() ? successor + 1 : size(), 0);
+    }
+    if (lastEdgeTo_[successor] > blockStart_.back()) {
+        const unsigned int e = lastEdgeTo_[successor] - 1;
+        if (keepParallel_) {
+            parallelEdge_.push_back(e);
+            parallelTransition_.push_back(costs_[e] < costs ? transition_[e] : transition);
+        }
+        if (costs_[e] < costs) {
+            costs_[e] = costs;
+            transition_[e] = transition;
+        }
+        return;
+    }
+
+    lastEdgeTo_[successor] = successor_.size() + 1;
+    successor_.push_back(successor);
+    costs_.push_back(costs);
+    transition_.push_back(transition);
+    finalized_ = false;
+}
+
+void InnerGraph::finalize() {
+    if (finalized_) {
+        return;
+    }
+
+    const unsigned int states = size();
+    const unsigned int nrOfBlocks = blockState_.size();
+    blockStart_.push_back(successor_.size());
+
+    // count the edges per state and check whether the blocks are already in order
+    std::vector<unsigned int> degree(states, 0);
+    bool ordered = true;
+    for (unsigned int b = 0; b < nrOfBlocks; ++b) {
+        degree[blockState_[b]] += blockStart_[b + 1] - blockStart_[b];
+        if (b > 0 and blockState_[b - 1] >= blockState_[b]) {
+            ordered = false;
+        }
+    }
+
+    offset_.assign(states + 1, 0);
+    for (unsigned int s = 0; s < states; ++s) {
+        offset_[s + 1] = offset_[s] + degree[s];
+    }
+
+    // scatter the blocks to their final position
+    if (not ordered) {
+        std::vector<unsigned int> successor(successor_.size());
+        std::vector<unsigned int> costs(costs_.size());
+        std::vector<pnapi::Transition*> transition(transition_.size());
+
+        // degree is reused as the insert position of each state
+        for (unsigned int s = 0; s < states; ++s) {
+            degree[s] = offset_[s];
+        }
+        std::vector<unsigned int> position(nrOfBlocks);
+        for (unsigned int b = 0; b < nrOfBlocks; ++b) {
+            unsigned int& pos = degree[blockState_[b]];
+            position[b] = pos;
+            for (unsigned int e = blockStart_[b]; e < blockStart_[b + 1]; ++e, ++pos) {
+                successor[pos] = successor_[e];
+                costs[pos] = costs_[e];
+                transition[pos] = transition_[e];
+            }
+        }
+
+        // the edges of kept parallel transitions moved along with their blocks
+        for (unsigned int i = 0; i < parallelEdge_.size(); ++i) {
+            const unsigned int e = parallelEdge_[i];
+            const unsigned int b = std::upper_bound(blockStart_.begin(), blockStart_.end() - 1, e) - blockStart_.begin() - 1;
+            parallelEdge_[i] = position[b] + (e - blockStart_[b]);
+        }
+
+        successor_.swap(successor);
+        costs_.swap(costs);
+        transition_.swap(transition);
+    }
+
+    // release the parsing information
+    std::vector<unsigned int>().swap(blockState_);
+    std::vector<unsigned int>().swap(blockStart_);
+    std::vector<unsigned int>().swap(lastEdgeTo_);
+
+    inStack_.assign(states, false);
+    finalized_ = true;
+}
+
+void InnerGraph::clear() {
+    offset_.assign(1, 0);
+    successor_.clear();
+    costs_.clear();
+    transition_.clear();
+    final_.clear();
+    inStack_.clear();
+    blockState_.clear();
+    blockStart_.clear();
+    lastEdgeTo_.clear();
+    parallelEdge_.clear();
+    parallelTransition_.clear();
+    finalized_ = false;
+}
+
+unsigned int InnerGraph::finals() const {
+    unsigned int result = 0;
+    for (unsigned int s = 0; s < size(); ++s) {
+        if (final_[s]) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+void InnerGraph::costs(const std::map<pnapi::Transition*, unsigned int>& costFunction,
+                       std::vector<unsigned int>& result) const {
+    result.assign(edges(), 0);
+    std::map<pnapi::Transition*, unsigned int>::const_iterator cost;
+    for (unsigned int e = 0; e < edges(); ++e) {
+        cost = costFunction.find(transition_[e]);
+        if (cost != costFunction.end()) {
+            result[e] = cost->second;
+        }
+    }
+    for (unsigned int i = 0; i < parallelTransitions(); ++i) {
+        cost = costFunction.find(parallelTransition_[i]);
+        if (cost != costFunction.end() and cost->second > result[parallelEdge_[i]]) {
+            result[parallelEdge_[i]] = cost->second;
+        }
+    }
+}
+
+unsigned int InnerGraph::sumOfLocalMaxCosts(const std::vector<unsigned int>& costs) const {
+    unsigned int result = 0;
+    for (unsigned int s = 0; s < size(); ++s) {
+        unsigned int localMax = 0;
+        for (unsigned int e = firstEdge(s); e < lastEdge(s); ++e) {
+            localMax = localMax > costs[e] ? localMax : costs[e];
+        }
+        result += localMax;
+    }
+    return result;
+}
+
+size_t InnerGraph::memoryUsage() const {
+    return offset_.capacity() * sizeof(unsigned int)
+         + successor_.capacity() * sizeof(unsigned int)
+         + costs_.capacity() * sizeof(unsigned int)
+         + transition_.capacity() * sizeof(pnapi::Transition*)
+         + (final_.capacity() + inStack_.capacity()) / 8
+         + (blockState_.capacity() + blockStart_.capacity() + lastEdgeTo_.capacity()) * sizeof(unsigned int)
+         + parallelEdge_.capacity() * sizeof(unsigned int)
+         + parallelTransition_.capacity() * sizeof(pnapi::Transition*);
+}
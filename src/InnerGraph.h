@@ -0,0 +1,163 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef INNER_GRAPH_H
+#define INNER_GRAPH_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include <pnapi/pnapi.h>
+
+/**
+ * @brief the inner graph, i.e. the state space of the composition of the net
+ * and its most-permissive partner
+ *
+ * The graph is stored in compressed sparse row layout: the outgoing edges of
+ * state s are the edges firstEdge(s), ..., lastEdge(s)-1 and successor, costs
+ * and transition of each edge are kept in packed arrays. Final states and
+ * the DFS stack flags are bitsets.
+ *
+ * While parsing, the edges of a state are appended en bloc by addEdge. As the
+ * blocks do not arrive in the order of the state numbers, finalize() has to be
+ * called once after parsing to build the offset array.
+ */
+class InnerGraph {
+public:
+    InnerGraph();
+
+    /// creates a new state without edges and returns its number
+    unsigned int addState();
+
+    /**
+     * @brief adds an edge from state to successor
+     *
+     * The edges of a state have to be added consecutively. Parallel edges
+     * (same state and successor) are merged, keeping the highest costs.
+     */
+    void addEdge(unsigned int state, unsigned int successor,
+                 pnapi::Transition* transition, unsigned int costs);
+
+    /// builds the offset array from the parsed edge blocks
+    void finalize();
+
+    /**
+     * @brief keeps the transitions of merged parallel edges
+     *
+     * The costs of parallel edges are only known under one cost function.
+     * To apply another one later, e.g. to a saved graph, the transitions of
+     * the edges that lost a merge are kept as parallel transitions of the
+     * remaining edge. Has to be called before the first edge is added.
+     */
+    void keepParallelTransitions() { keepParallel_ = true; }
+
+    /// the number of kept parallel transitions
+    unsigned int parallelTransitions() const { return parallelEdge_.size(); }
+
+    /// the edge the i-th kept parallel transition was merged into
+    unsigned int parallelEdge(unsigned int i) const { return parallelEdge_[i]; }
+
+    /// the i-th kept parallel transition
+    pnapi::Transition* parallelTransition(unsigned int i) const { return parallelTransition_[i]; }
+
+    /// removes all states and edges
+    void clear();
+
+    /// the number of states
+    unsigned int size() const { return final_.size(); }
+
+    /// the number of edges
+    unsigned int edges() const { return successor_.size(); }
+
+    /// the number of final states
+    unsigned int finals() const;
+
+    /// the first outgoing edge of a state
+    unsigned int firstEdge(unsigned int state) const { return offset_[state]; }
+
+    /// one behind the last outgoing edge of a state
+    unsigned int lastEdge(unsigned int state) const { return offset_[state + 1]; }
+
+    /// the target state of an edge
+    unsigned int successor(unsigned int edge) const { return successor_[edge]; }
+
+    /// the costs of an edge
+    unsigned int costs(unsigned int edge) const { return costs_[edge]; }
+
+    /// the costs of all edges
+    const std::vector<unsigned int>& costs() const { return costs_; }
+
+    /**
+     * @brief the costs of all edges under another cost function
+     *
+     * An edge costs as much as the most expensive of its transition and the
+     * parallel transitions merged into it, so the result is only exact if
+     * the parallel transitions were kept.
+     */
+    void costs(const std::map<pnapi::Transition*, unsigned int>& costFunction,
+               std::vector<unsigned int>& result) const;
+
+    /// the transition an edge is labeled with
+    pnapi::Transition* transition(unsigned int edge) const { return transition_[edge]; }
+
+    bool isFinal(unsigned int state) const { return final_[state]; }
+    void setFinal(unsigned int state, bool final) { final_[state] = final; }
+
+    bool inStack(unsigned int state) const { return inStack_[state]; }
+    void setInStack(unsigned int state, bool inStack) { inStack_[state] = inStack; }
+
+    /// the sum over all states of the costs of their most expensive outgoing edge
+    unsigned int sumOfLocalMaxCosts() const { return sumOfLocalMaxCosts(costs_); }
+
+    /// the same sum for the given costs of the edges
+    unsigned int sumOfLocalMaxCosts(const std::vector<unsigned int>& costs) const;
+
+    /// the number of bytes allocated for the graph
+    size_t memoryUsage() const;
+
+private:
+    /// offset_[s] is the index of the first edge of state s (size() + 1 entries)
+    std::vector<unsigned int> offset_;
+
+    /// the packed edge arrays
+    std::vector<unsigned int> successor_;
+    std::vector<unsigned int> costs_;
+    std::vector<pnapi::Transition*> transition_;
+
+    /// bitsets for final states and for the states on the DFS stack
+    std::vector<bool> final_;
+    std::vector<bool> inStack_;
+
+    /// while parsing: the state and the first edge of each edge block
+    std::vector<unsigned int> blockState_;
+    std::vector<unsigned int> blockStart_;
+
+    /// while parsing: for each successor, one plus the index of the last edge
+    /// to it; entries not pointing into the current block are outdated
+    std::vector<unsigned int> lastEdgeTo_;
+
+    /// the transitions of merged parallel edges and the edges they were merged into
+    std::vector<unsigned int> parallelEdge_;
+    std::vector<pnapi::Transition*> parallelTransition_;
+
+    bool keepParallel_;
+    bool finalized_;
+};
+
+#endif
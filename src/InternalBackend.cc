@@ -0,0 +1,483 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include <fstream>
+#include "InternalBackend.h"
+#include "verbose.h"
+
+KnowledgeGraph::KnowledgeGraph(const pnapi::PetriNet& net, unsigned int messageBound)
+    : finalCondition_(net), messageBound_(messageBound), closures_(0) {
+
+    compile(net);
+
+    // the initial node
+    std::vector<unsigned int> states(1, 0);
+    closure(states);
+
+    // explore the events of the good nodes in breadth-first order
+    const unsigned int labels = labelName_.size();
+    for (unsigned int node = 0; node < knowledge_.size(); ++node) {
+        if (bad_[node]) {
+            continue;
+        }
+        for (unsigned int label = 0; label < labels; ++label) {
+            if (event(node, label, states)) {
+                const unsigned int successor = closure(states);
+                edge_[node * labels + label] = successor;
+            }
+        }
+    }
+
+    reduce();
+}
+
+void KnowledgeGraph::compile(const pnapi::PetriNet& net) {
+    const unsigned int places = finalCondition_.places();
+
+    if (not net.getInterface().getSynchronousLabels().empty()) {
+        abort(9, "the internal backend does not support synchronous labels; use --backend=wendy");
+    }
+
+    // number the labels after the places, sorted by name
+    std::map<std::string, pnapi::Label*> labels;
+    const std::set<pnapi::Label*> asynchronous = net.getInterface().getAsynchronousLabels();
+    for (std::set<pnapi::Label*>::const_iterator l = asynchronous.begin(); l != asynchronous.end(); ++l) {
+        labels[(*l)->getName()] = *l;
+    }
+    std::map<const pnapi::Label*, unsigned int> labelNumber;
+    for (std::map<std::string, pnapi::Label*>::const_iterator l = labels.begin(); l != labels.end(); ++l) {
+        labelNumber[l->second] = places + labelName_.size();
+        labelName_.push_back(l->first);
+        isInput_.push_back(l->second->getType() == pnapi::Label::INPUT);
+    }
+    width_ = places + labelName_.size();
+
+    // the tokens and messages consumed and produced by each transition
+    const pnapi::PetriNet::Transitions& transitions = net.getTransitions();
+    for (pnapi::PetriNet::Transitions::const_iterator t = transitions.begin(); t != transitions.end(); ++t) {
+        std::vector<Change> consume;
+        std::vector<Change> produce;
+
+        const std::set<pnapi::Arc*>& preset = (*t)->getPresetArcs();
+        for (std::set<pnapi::Arc*>::const_iterator a = preset.begin(); a != preset.end(); ++a) {
+            Change change = { finalCondition_.number((*a)->getPlace()), (*a)->getWeight() };
+            consume.push_back(change);
+        }
+        const std::set<pnapi::Arc*>& postset = (*t)->getPostsetArcs();
+        for (std::set<pnapi::Arc*>::const_iterator a = postset.begin(); a != postset.end(); ++a) {
+            Change change = { finalCondition_.number((*a)->getPlace()), (*a)->getWeight() };
+            produce.push_back(change);
+        }
+        const std::map<pnapi::Label*, unsigned int>& transitionLabels = (*t)->getLabels();
+        for (std::map<pnapi::Label*, unsigned int>::const_iterator l = transitionLabels.begin(); l != transitionLabels.end(); ++l) {
+            Change change = { labelNumber[l->first], l->second };
+            if (l->first->getType() == pnapi::Label::INPUT) {
+                consume.push_back(change);
+            } else {
+                produce.push_back(change);
+            }
+        }
+
+        consume_.push_back(consume);
+        produce_.push_back(produce);
+    }
+
+    // the initial state gets number 0
+    std::vector<unsigned int> initial(width_, 0);
+    const pnapi::PetriNet::Places& netPlaces = net.getPlaces();
+    for (pnapi::PetriNet::Places::const_iterator p = netPlaces.begin(); p != netPlaces.end(); ++p) {
+        initial[finalCondition_.number(**p)] = (*p)->getTokenCount();
+    }
+    table_.assign(1024, 0);
+    findState(initial, true);
+}
+
+unsigned int KnowledgeGraph::findState(const std::vector<unsigned int>& state, bool insert) {
+    // FNV-1a hash over the token counts
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < width_; ++i) {
+        hash = (hash ^ state[i]) * 16777619u;
+    }
+
+    const unsigned int mask = table_.size() - 1;
+    unsigned int slot = hash & mask;
+    for (; table_[slot] != 0; slot = (slot + 1) & mask) {
+        const unsigned int candidate = table_[slot] - 1;
+        if (std::equal(state.begin(), state.begin() + width_, pool_.begin() + candidate * width_)) {
+            return candidate;
+        }
+    }
+    if (not insert) {
+        return NONE;
+    }
+
+    const unsigned int result = states();
+    pool_.insert(pool_.end(), state.begin(), state.begin() + width_);
+    table_[slot] = result + 1;
+    successors_.push_back(std::vector<unsigned int>());
+    expanded_.push_back(false);
+    visited_.push_back(0);
+
+    bool overflow = false;
+    for (unsigned int i = finalCondition_.places(); i < width_; ++i) {
+        overflow = overflow or state[i] > messageBound_;
+    }
+    overflow_.push_back(overflow);
+
+    // keep the table at most half full
+    if (2 * states() > table_.size()) {
+        std::vector<unsigned int> table(2 * table_.size(), 0);
+        const unsigned int newMask = table.size() - 1;
+        for (unsigned int s = 0; s < states(); ++s) {
+            unsigned int h = 2166136261u;
+            for (unsigned int i = 0; i < width_; ++i) {
+                h = (h ^ pool_[s * width_ + i]) * 16777619u;
+            }
+            unsigned int newSlot = h & newMask;
+            while (table[newSlot] != 0) {
+                newSlot = (newSlot + 1) & newMask;
+            }
+            table[newSlot] = s + 1;
+        }
+        table_.swap(table);
+    }
+
+    return result;
+}
+
+void KnowledgeGraph::expand(unsigned int state) {
+    expanded_[state] = true;
+    if (overflow_[state]) {
+        return;
+    }
+
+    std::vector<unsigned int> successor(width_);
+    std::vector<unsigned int> result;
+    for (unsigned int t = 0; t < consume_.size(); ++t) {
+        const unsigned int* current = &pool_[state * width_];
+
+        bool enabled = true;
+        for (unsigned int c = 0; c < consume_[t].size() and enabled; ++c) {
+            enabled = current[consume_[t][c].index] >= consume_[t][c].count;
+        }
+        if (not enabled) {
+            continue;
+        }
+
+        std::copy(current, current + width_, successor.begin());
+        for (unsigned int c = 0; c < consume_[t].size(); ++c) {
+            successor[consume_[t][c].index] -= consume_[t][c].count;
+        }
+        for (unsigned int c = 0; c < produce_[t].size(); ++c) {
+            successor[produce_[t][c].index] += produce_[t][c].count;
+        }
+        // findState may move the pool
+        result.push_back(findState(successor, true));
+    }
+
+    successors_[state].swap(result);
+}
+
+unsigned int KnowledgeGraph::closure(std::vector<unsigned int>& states) {
+    ++closures_;
+
+    // states is used as the queue of the search and holds the result
+    unsigned int queued = 0;
+    for (unsigned int i = 0; i < states.size(); ++i) {
+        if (visited_[states[i]] != closures_) {
+            visited_[states[i]] = closures_;
+            states[queued++] = states[i];
+        }
+    }
+    states.resize(queued);
+
+    bool overflow = false;
+    for (unsigned int i = 0; i < states.size(); ++i) {
+        const unsigned int state = states[i];
+        if (not expanded_[state]) {
+            expand(state);
+        }
+        overflow = overflow or overflow_[state];
+
+        const std::vector<unsigned int>& successors = successors_[state];
+        for (unsigned int s = 0; s < successors.size(); ++s) {
+            if (visited_[successors[s]] != closures_) {
+                visited_[successors[s]] = closures_;
+                states.push_back(successors[s]);
+            }
+        }
+    }
+    std::sort(states.begin(), states.end());
+
+    std::map<std::vector<unsigned int>, unsigned int>::iterator node = nodeNumber_.find(states);
+    if (node != nodeNumber_.end()) {
+        return node->second;
+    }
+
+    const unsigned int result = knowledge_.size();
+    nodeNumber_[states] = result;
+    knowledge_.push_back(states);
+    edge_.resize(edge_.size() + labelName_.size(), NONE);
+    bad_.push_back(overflow);
+    return result;
+}
+
+bool KnowledgeGraph::event(unsigned int node, unsigned int label, std::vector<unsigned int>& states) {
+    const unsigned int index = finalCondition_.places() + label;
+    const std::vector<unsigned int>& knowledge = knowledge_[node];
+    std::vector<unsigned int> state(width_);
+
+    // the states are collected first, as findState may move the pool
+    std::vector<unsigned int> collected;
+    for (unsigned int i = 0; i < knowledge.size(); ++i) {
+        const unsigned int* current = &pool_[knowledge[i] * width_];
+        if (isInput_[label]) {
+            // sending must not exceed the message bound in any state
+            if (current[index] >= messageBound_) {
+                return false;
+            }
+            collected.push_back(knowledge[i]);
+        } else if (current[index] > 0) {
+            // only states with a pending message can receive it
+            collected.push_back(knowledge[i]);
+        }
+    }
+    if (collected.empty()) {
+        return false;
+    }
+
+    states.clear();
+    for (unsigned int i = 0; i < collected.size(); ++i) {
+        std::copy(pool_.begin() + collected[i] * width_, pool_.begin() + (collected[i] + 1) * width_, state.begin());
+        if (isInput_[label]) {
+            ++state[index];
+        } else {
+            --state[index];
+        }
+        states.push_back(findState(state, true));
+    }
+    return true;
+}
+
+bool KnowledgeGraph::isFinal(unsigned int state) const {
+    const unsigned int* current = &pool_[state * width_];
+    for (unsigned int i = finalCondition_.places(); i < width_; ++i) {
+        if (current[i] != 0) {
+            return false;
+        }
+    }
+    return finalCondition_.isSatisfied(current);
+}
+
+void KnowledgeGraph::reduce() {
+    const unsigned int labels = labelName_.size();
+
+    // the states of the composition are pairs of a node and one of its
+    // states; pair offset[node] + i refers to the i-th state of a node
+    std::vector<unsigned int> offset(nodes() + 1, 0);
+    for (unsigned int node = 0; node < nodes(); ++node) {
+        offset[node + 1] = offset[node] + knowledge_[node].size();
+    }
+    const unsigned int pairs = offset.back();
+    std::vector<unsigned int> nodeOf(pairs);
+
+    // the transitions of the composition between pairs of good nodes
+    std::vector<unsigned int> from;
+    std::vector<unsigned int> to;
+    std::vector<unsigned int> state(width_);
+    for (unsigned int node = 0; node < nodes(); ++node) {
+        const std::vector<unsigned int>& knowledge = knowledge_[node];
+        for (unsigned int i = 0; i < knowledge.size(); ++i) {
+            nodeOf[offset[node] + i] = node;
+        }
+        if (bad_[node]) {
+            continue;
+        }
+
+        for (unsigned int i = 0; i < knowledge.size(); ++i) {
+            const unsigned int pair = offset[node] + i;
+
+            // a transition of the net stays in the node
+            const std::vector<unsigned int>& successors = successors_[knowledge[i]];
+            for (unsigned int s = 0; s < successors.size(); ++s) {
+                from.push_back(pair);
+                to.push_back(offset[node] + (std::lower_bound(knowledge.begin(), knowledge.end(), successors[s]) - knowledge.begin()));
+            }
+
+            // an event of the partner leads to the successor node
+            for (unsigned int label = 0; label < labels; ++label) {
+                const unsigned int successor = edge_[node * labels + label];
+                if (successor == NONE or bad_[successor]) {
+                    continue;
+                }
+                const unsigned int index = finalCondition_.places() + label;
+                std::copy(pool_.begin() + knowledge[i] * width_, pool_.begin() + (knowledge[i] + 1) * width_, state.begin());
+                if (isInput_[label]) {
+                    ++state[index];
+                } else if (state[index] > 0) {
+                    --state[index];
+                } else {
+                    continue;
+                }
+                const std::vector<unsigned int>& target = knowledge_[successor];
+                from.push_back(pair);
+                to.push_back(offset[successor] + (std::lower_bound(target.begin(), target.end(), findState(state, false)) - target.begin()));
+            }
+        }
+    }
+
+    // the predecessors of each pair
+    std::vector<unsigned int> start(pairs + 1, 0);
+    for (unsigned int e = 0; e < to.size(); ++e) {
+        ++start[to[e] + 1];
+    }
+    for (unsigned int p = 0; p < pairs; ++p) {
+        start[p + 1] += start[p];
+    }
+    std::vector<unsigned int> predecessor(from.size());
+    std::vector<unsigned int> position(start.begin(), start.end() - 1);
+    for (unsigned int e = 0; e < to.size(); ++e) {
+        predecessor[position[to[e]]++] = from[e];
+    }
+    std::vector<unsigned int>().swap(from);
+    std::vector<unsigned int>().swap(to);
+
+    // remove the nodes with a pair which cannot reach a final pair; the
+    // transitions into removed nodes vanish with them
+    std::vector<bool> reached;
+    std::vector<unsigned int> queue;
+    bool changed = true;
+    while (changed) {
+        reached.assign(pairs, false);
+        queue.clear();
+        for (unsigned int p = 0; p < pairs; ++p) {
+            if (not bad_[nodeOf[p]] and isFinal(knowledge_[nodeOf[p]][p - offset[nodeOf[p]]])) {
+                reached[p] = true;
+                queue.push_back(p);
+            }
+        }
+        for (unsigned int i = 0; i < queue.size(); ++i) {
+            for (unsigned int e = start[queue[i]]; e < start[queue[i] + 1]; ++e) {
+                const unsigned int p = predecessor[e];
+                if (not reached[p] and not bad_[nodeOf[p]]) {
+                    reached[p] = true;
+                    queue.push_back(p);
+                }
+            }
+        }
+
+        changed = false;
+        for (unsigned int p = 0; p < pairs; ++p) {
+            if (not reached[p] and not bad_[nodeOf[p]]) {
+                bad_[nodeOf[p]] = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+void KnowledgeGraph::toAutomaton(pnapi::Automaton& partner) const {
+    const unsigned int labels = labelName_.size();
+
+    // the partner sends what the net receives and vice versa
+    for (unsigned int label = 0; label < labels; ++label) {
+        if (isInput_[label]) {
+            partner.addOutputLabel(labelName_[label]);
+        } else {
+            partner.addInputLabel(labelName_[label]);
+        }
+    }
+    if (bad_[0]) {
+        return;
+    }
+
+    // number the good nodes reachable from the initial node
+    std::vector<pnapi::State*> state(nodes(), static_cast<pnapi::State*>(0));
+    std::vector<unsigned int> queue(1, 0);
+    state[0] = &partner.createState(0);
+    state[0]->setInitial();
+    for (unsigned int i = 0; i < queue.size(); ++i) {
+        const unsigned int node = queue[i];
+        for (unsigned int label = 0; label < labels; ++label) {
+            const unsigned int successor = edge_[node * labels + label];
+            if (successor == NONE or bad_[successor] or state[successor] != 0) {
+                continue;
+            }
+            state[successor] = &partner.createState(queue.size());
+            queue.push_back(successor);
+        }
+    }
+
+    for (unsigned int i = 0; i < queue.size(); ++i) {
+        const unsigned int node = queue[i];
+        const std::vector<unsigned int>& knowledge = knowledge_[node];
+        for (unsigned int s = 0; s < knowledge.size(); ++s) {
+            if (isFinal(knowledge[s])) {
+                state[node]->setFinal();
+                break;
+            }
+        }
+        for (unsigned int label = 0; label < labels; ++label) {
+            const unsigned int successor = edge_[node * labels + label];
+            if (successor == NONE or bad_[successor]) {
+                continue;
+            }
+            partner.createEdge(*state[node], *state[successor], labelName_[label],
+                               isInput_[label] ? pnapi::Edge::OUTPUT : pnapi::Edge::INPUT);
+        }
+    }
+}
+
+
+std::string InternalBackend::options(bool useWendyOptimization) const {
+    // the reductions of wendy do not change the verdict
+    return "internal --correctness=livelock";
+}
+
+bool InternalBackend::check(pnapi::PetriNet &net, bool useWendyOptimization) {
+    KnowledgeGraph graph(net);
+    status("knowledge graph: %d nodes, %d states", graph.nodes(), graph.states());
+    return graph.controllable();
+}
+
+void InternalBackend::computeMP(pnapi::PetriNet &net, const std::string &outputFile, bool dot) {
+    KnowledgeGraph graph(net);
+    status("knowledge graph: %d nodes, %d states", graph.nodes(), graph.states());
+
+    // like wendy, write no partner if there is none
+    if (not graph.controllable()) {
+        return;
+    }
+
+    pnapi::Automaton partner;
+    graph.toAutomaton(partner);
+
+    std::ofstream file(outputFile.c_str());
+    file << pnapi::io::sa << partner;
+    if (dot) {
+        std::ofstream dotFile((outputFile + ".dot").c_str());
+        dotFile << pnapi::io::dot << partner;
+    }
+}
+
+void InternalBackend::computeOG(pnapi::PetriNet &net, const std::string &outputFile, bool dot) {
+    // the annotations of an operating guideline are left to wendy
+    WendyBackend().computeOG(net, outputFile, dot);
+}
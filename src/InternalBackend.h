@@ -0,0 +1,148 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef INTERNAL_BACKEND_H
+#define INTERNAL_BACKEND_H
+
+#include <climits>
+#include <map>
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+#include "FinalCondition.h"
+#include "ServiceTools.h"
+
+/**
+ * @brief the knowledge graph of an open net, i.e. its most-permissive partner
+ *
+ * A state of the net is a vector of the token counts of its places, followed
+ * by the number of pending messages of each label. A node of the graph is
+ * the knowledge of a partner: the set of states the net may be in after the
+ * messages on a path to the node have been sent and received.
+ *
+ * A node is bad if one of its states exceeds the message bound, or if one of
+ * its states cannot reach a final state in the composition with the graph of
+ * the good nodes. Bad nodes are removed until a fixed point is reached; the
+ * net is controllable iff the initial node survives.
+ */
+class KnowledgeGraph {
+public:
+    /// builds and reduces the knowledge graph of the given net
+    KnowledgeGraph(const pnapi::PetriNet& net, unsigned int messageBound = 1);
+
+    /// whether the initial node survived
+    bool controllable() const { return not bad_[0]; }
+
+    /// the number of nodes and states of the net explored
+    unsigned int nodes() const { return knowledge_.size(); }
+    unsigned int states() const { return pool_.size() / width_; }
+
+    /// writes the good nodes reachable from the initial node as service automaton
+    void toAutomaton(pnapi::Automaton& partner) const;
+
+private:
+    /// returned if there is no node or state
+    static const unsigned int NONE = UINT_MAX;
+
+    /// a change of a place or label by firing a transition
+    struct Change {
+        unsigned int index;
+        unsigned int count;
+    };
+
+    /// compiles the transitions, labels, and the initial state of the net
+    void compile(const pnapi::PetriNet& net);
+
+    /// the number of a state; inserts unknown states if insert is set
+    unsigned int findState(const std::vector<unsigned int>& state, bool insert);
+
+    /// computes the successors of a state under the transitions of the net
+    void expand(unsigned int state);
+
+    /// the node of the states reachable from the given ones
+    unsigned int closure(std::vector<unsigned int>& states);
+
+    /// the states the partner reaches by sending or receiving a message
+    bool event(unsigned int node, unsigned int label, std::vector<unsigned int>& states);
+
+    /// whether a state satisfies the final condition with no pending messages
+    bool isFinal(unsigned int state) const;
+
+    /// removes bad nodes until a fixed point is reached
+    void reduce();
+
+    /// the compiled final condition, which also numbers the places
+    FinalCondition finalCondition_;
+
+    /// the size of a state: places, then labels
+    unsigned int width_;
+
+    /// the bound of pending messages per label
+    unsigned int messageBound_;
+
+    /// the labels: names and whether the net receives (partner sends) them
+    std::vector<std::string> labelName_;
+    std::vector<bool> isInput_;
+
+    /// consumed and produced tokens and messages of each transition
+    std::vector<std::vector<Change> > consume_;
+    std::vector<std::vector<Change> > produce_;
+
+    /// the states of the net, width_ entries each, and a hash table over them
+    std::vector<unsigned int> pool_;
+    std::vector<unsigned int> table_;
+
+    /// the successors of each state under the transitions of the net
+    std::vector<std::vector<unsigned int> > successors_;
+    std::vector<bool> expanded_;
+
+    /// states exceeding the message bound
+    std::vector<bool> overflow_;
+
+    /// for closure(): the last closure each state was visited in
+    std::vector<unsigned int> visited_;
+    unsigned int closures_;
+
+    /// the nodes: the sorted states of each node and the node numbers
+    std::vector<std::vector<unsigned int> > knowledge_;
+    std::map<std::vector<unsigned int>, unsigned int> nodeNumber_;
+
+    /// successor node of each node and label (NONE if the event is impossible)
+    std::vector<unsigned int> edge_;
+
+    /// the nodes removed
+    std::vector<bool> bad_;
+};
+
+/**
+ * @brief decides controllability in process on the knowledge graph
+ *
+ * No process is started and the net is not serialized. Operating guidelines
+ * are still computed by wendy.
+ */
+class InternalBackend : public ControllabilityBackend {
+public:
+    const char* name() const { return "internal"; }
+    std::string options(bool useWendyOptimization) const;
+    bool check(pnapi::PetriNet &net, bool useWendyOptimization);
+    void computeMP(pnapi::PetriNet &net, const std::string &outputFile, bool dot);
+    void computeOG(pnapi::PetriNet &net, const std::string &outputFile, bool dot);
+};
+
+#endif
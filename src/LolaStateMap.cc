@@ -0,0 +1,66 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+
+#include <algorithm>
+#include <climits>
+#include "LolaStateMap.h"
+
+/// marks the entries of the dense mapping without a state
+static const unsigned int NO_STATE = UINT_MAX;
+
+/// the dense mapping grows up to this many entries ahead of the state count
+static const unsigned int DENSE_SLACK = 1024;
+
+LolaStateMap::LolaStateMap(InnerGraph& graph) : graph_(graph) {}
+
+unsigned int LolaStateMap::state(unsigned int lolaState) {
+    if (lolaState < dense_.size()) {
+        if (dense_[lolaState] != NO_STATE) {
+            return dense_[lolaState];
+        }
+    } else if (lolaState < 2 * graph_.size() + DENSE_SLACK) {
+        grow(std::max(lolaState + 1, 2 * static_cast<unsigned int>(dense_.size())));
+        // the number may have been seen before while it was kept in the map
+        if (dense_[lolaState] != NO_STATE) {
+            return dense_[lolaState];
+        }
+    } else {
+        std::map<unsigned int, unsigned int>::iterator it = sparse_.find(lolaState);
+        if (it != sparse_.end()) {
+            return it->second;
+        }
+        const unsigned int state = graph_.addState();
+        sparse_[lolaState] = state;
+        return state;
+    }
+
+    const unsigned int state = graph_.addState();
+    dense_[lolaState] = state;
+    return state;
+}
+
+void LolaStateMap::grow(unsigned int size) {
+    dense_.resize(size, NO_STATE);
+    std::map<unsigned int, unsigned int>::iterator it = sparse_.begin();
+    while (it != sparse_.end() and it->first < size) {
+        dense_[it->first] = it->second;
+        sparse_.erase(it++);
+    }
+}
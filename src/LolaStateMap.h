@@ -0,0 +1,57 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef LOLA_STATE_MAP_H
+#define LOLA_STATE_MAP_H
+
+#include <map>
+#include <vector>
+#include "InnerGraph.h"
+
+/**
+ * @brief maps the state numbers of LoLA to the states of an inner graph
+ *
+ * The state of the graph is created when a number is seen the first time.
+ * LoLA numbers its states densely, so the numbers are used as index into a
+ * vector. Numbers far beyond the states seen so far are kept in a map
+ * instead, until the vector grows past them and they are moved into it.
+ * Both parsers of state spaces use this map, so the states are numbered the
+ * same way no matter which one reads the file.
+ */
+class LolaStateMap {
+public:
+    explicit LolaStateMap(InnerGraph& graph);
+
+    /// the state of the graph for a state number of LoLA
+    unsigned int state(unsigned int lolaState);
+
+private:
+    InnerGraph& graph_;
+
+    /// the state for each number below its size, or NO_STATE
+    std::vector<unsigned int> dense_;
+
+    /// the states for numbers not below the size of dense_
+    std::map<unsigned int, unsigned int> sparse_;
+
+    /// enlarges dense_ and moves the entries of sparse_ it now covers
+    void grow(unsigned int size);
+};
+
+#endif
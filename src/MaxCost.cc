@@ -18,6 +18,9 @@
 \*****************************************************************************/
 #include <stack>
 #include <map>
+#include <queue>
+#include <vector>
+#include <climits>
 #include <stdio.h>
 #include <pnapi/pnapi.h>
 
@@ -37,6 +40,7 @@ unsigned int maxCost(pnapi::PetriNet* net) {
     bool USE_SIMPLE = Tara::args_info.heuristics_given && Tara::args_info.heuristics_arg == heuristics_arg_simple;
     bool USE_MAXOUT = Tara::args_info.heuristics_given && Tara::args_info.heuristics_arg == heuristics_arg_maxout;
     bool USE_LP = Tara::args_info.heuristics_given && Tara::args_info.heuristics_arg == heuristics_arg_lp;
+    bool USE_SCC = Tara::args_info.heuristics_given && Tara::args_info.heuristics_arg == heuristics_arg_scc;
 
     if (USE_SIMPLE) {
     	status("Optimization enabled: simple.");
@@ -44,8 +48,8 @@ unsigned int maxCost(pnapi::PetriNet* net) {
         int maxTransCost = 0;
 
         //iterate over all transitions of the net
-        std::set<pnapi::Transition*> allTransitions=net->getTransitions();
-        for(std::set<pnapi::Transition*>::iterator it=allTransitions.begin();it!=allTransitions.end();it++) {
+        const pnapi::PetriNet::Transitions& allTransitions=net->getTransitions();
+        for(pnapi::PetriNet::Transitions::const_iterator it=allTransitions.begin();it!=allTransitions.end();it++) {
           // the cost of that transition
           int curCost=Tara::cost(*it);
 
@@ -75,10 +79,31 @@ unsigned int maxCost(pnapi::PetriNet* net) {
         return val;
     }
 
+    // the bound of the condensation is exact on acyclic graphs and limits
+    // the search for the longest path otherwise
+    bool exact;
+    const unsigned int sccBound = sccUpperBound(exact);
 
-   Tara::graph[Tara::initialState]->curCost=0;
-   Tara::graph[Tara::initialState]->inStack=true;
-   Tara::graph[Tara::initialState]->curTransition = Tara::graph[Tara::initialState]->transitions.begin();
+    if (USE_SCC or exact) {
+        status("Optimization enabled: SCC%s.", exact ? " (graph is acyclic, bound is exact)" : "");
+        Tara::minCosts = minimalCost();
+        status("Using SCC upper bound: %d", sccBound);
+        status("Using lower bound: %d", Tara::minCosts);
+        return sccBound;
+    }
+
+    // the longest simple path cannot be more expensive than either bound
+    const unsigned int bound = sccBound < Tara::sumOfLocalMaxCosts ? sccBound : Tara::sumOfLocalMaxCosts;
+
+
+   // DFS information per state: the next edge to visit and the costs of the
+   // edge the state was reached with
+   std::vector<unsigned int> curEdge(Tara::graph.size());
+   std::vector<unsigned int> stateCost(Tara::graph.size());
+
+   stateCost[Tara::initialState]=0;
+   Tara::graph.setInStack(Tara::initialState, true);
+   curEdge[Tara::initialState] = Tara::graph.firstEdge(Tara::initialState);
    nodeStack.push_back(Tara::initialState);
     
    unsigned int maxCost = 0;
@@ -89,9 +114,14 @@ unsigned int maxCost(pnapi::PetriNet* net) {
    while(!nodeStack.empty()) {
        int tos(nodeStack.back()); /* tos = Top Of Stack */
      
-       if (maxCost == Tara::sumOfLocalMaxCosts) { status("Found a path which is equal to maxout upper bound."); return maxCost; }
+       if (maxCost == bound) {
+           status("Found a path which is equal to the %s upper bound.", bound == sccBound ? "SCC" : "maxout");
+           nodeStack.clear();
+           Tara::minCosts = minimalCost();
+           return maxCost;
+       }
        // if accepting state, update MaxCost
-       if(Tara::graph[tos]->final) {
+       if(Tara::graph.isFinal(tos)) {
            maxCost = maxCost > curCost ? maxCost : curCost;
            if(minCost == -1) {
                minCost = curCost;
@@ -103,41 +133,41 @@ unsigned int maxCost(pnapi::PetriNet* net) {
         }
     
        /* if all childs are visited, remove from stack and reset properties */
-       if(Tara::graph[tos]->curTransition == Tara::graph[tos]->transitions.end()) {
+       if(curEdge[tos] == Tara::graph.lastEdge(tos)) {
     //          status("Found a path of length %d with costs %d", curLen, curCost);
 	      --curLen;
-              curCost=curCost-Tara::graph[tos]->curCost;
-              Tara::graph[tos]->inStack=false;
-              Tara::graph[tos]->curTransition = Tara::graph[tos]->transitions.begin();
+              curCost=curCost-stateCost[tos];
+              Tara::graph.setInStack(tos, false);
+              curEdge[tos] = Tara::graph.firstEdge(tos);
 	      nodeStack.pop_back();
 	      continue;
        }
 
        //check if next node is on Stack, as we dont want to count cycles
-       if(Tara::graph[Tara::graph[tos]->curTransition->successor]->inStack) {
-           ++(Tara::graph[tos]->curTransition);
-	//   status("Saw an old node: %d", Tara::graph[tos]->curTransition->successor);
+       if(Tara::graph.inStack(Tara::graph.successor(curEdge[tos]))) {
+           ++curEdge[tos];
+	//   status("Saw an old node: %d", Tara::graph.successor(curEdge[tos]));
            continue;
        }
       
        { 
           //push child
-          int next=Tara::graph[tos]->curTransition->successor;
+          int next=Tara::graph.successor(curEdge[tos]);
           nodeStack.push_back(next);
-          Tara::graph[next]->inStack=true;
-          Tara::graph[next]->curTransition = Tara::graph[next]->transitions.begin();
+          Tara::graph.setInStack(next, true);
+          curEdge[next] = Tara::graph.firstEdge(next);
           ++curLen;
           // get costs for that transition
-          unsigned int transitionCost= Tara::graph[tos]->curTransition->costs;
+          unsigned int transitionCost= Tara::graph.costs(curEdge[tos]);
 
           // save the cost to that state
           // if this state is removed from stack, the cost will be subtracted
-          Tara::graph[next]->curCost=transitionCost;
+          stateCost[next]=transitionCost;
           curCost+=transitionCost;
        }
  
        //for current tos goto next transition
-       ++(Tara::graph[tos]->curTransition);
+       ++curEdge[tos];
    }
  	status("Using upper bound: %d", maxCost);        
  	status("Using lower bound: %d", minCost);        
@@ -145,3 +175,249 @@ unsigned int maxCost(pnapi::PetriNet* net) {
   	return maxCost;
    //printf("\n maxCost: %d \n\n", maxCost);
 }
+
+
+unsigned int sccUpperBound(bool& exact) {
+    return sccUpperBound(Tara::graph.costs(), exact);
+}
+
+
+unsigned int sccUpperBound(const std::vector<unsigned int>& costs, bool& exact) {
+    const InnerGraph& graph = Tara::graph;
+    const unsigned int NONE = UINT_MAX;
+    exact = true;
+
+    if (graph.size() == 0) {
+        return 0;
+    }
+
+    // Tarjan's algorithm from the initial state with an explicit stack;
+    // components are numbered in reverse topological order
+    std::vector<unsigned int> index(graph.size(), NONE);
+    std::vector<unsigned int> lowlink(graph.size(), 0);
+    std::vector<unsigned int> component(graph.size(), NONE);
+    std::vector<unsigned int> edge(graph.size(), 0);
+    std::vector<unsigned int> tarjanStack;
+    std::vector<unsigned int> callStack;
+    std::vector<unsigned int> componentStart(1, 0);
+    std::vector<unsigned int> members;
+    unsigned int nextIndex = 0;
+
+    index[Tara::initialState] = lowlink[Tara::initialState] = nextIndex++;
+    edge[Tara::initialState] = graph.firstEdge(Tara::initialState);
+    tarjanStack.push_back(Tara::initialState);
+    callStack.push_back(Tara::initialState);
+
+    while (not callStack.empty()) {
+        const unsigned int s = callStack.back();
+
+        if (edge[s] < graph.lastEdge(s)) {
+            const unsigned int t = graph.successor(edge[s]++);
+            if (index[t] == NONE) {
+                index[t] = lowlink[t] = nextIndex++;
+                edge[t] = graph.firstEdge(t);
+                tarjanStack.push_back(t);
+                callStack.push_back(t);
+            } else if (component[t] == NONE and index[t] < lowlink[s]) {
+                lowlink[s] = index[t];
+            }
+            continue;
+        }
+
+        callStack.pop_back();
+        if (not callStack.empty() and lowlink[s] < lowlink[callStack.back()]) {
+            lowlink[callStack.back()] = lowlink[s];
+        }
+
+        // s is the root of a component
+        if (lowlink[s] == index[s]) {
+            const unsigned int c = componentStart.size() - 1;
+            unsigned int t;
+            do {
+                t = tarjanStack.back();
+                tarjanStack.pop_back();
+                component[t] = c;
+                members.push_back(t);
+            } while (t != s);
+            componentStart.push_back(members.size());
+        }
+    }
+
+    // successors of a component have smaller numbers, so the longest path
+    // to a final state can be computed in the order of the numbers
+    const unsigned int components = componentStart.size() - 1;
+    std::vector<long long> longest(components, -1);
+    for (unsigned int c = 0; c < components; ++c) {
+
+        // a simple path within the component leaves each but its last state
+        // at most once, with one of the edges within the component
+        unsigned long long internal = 0;
+        unsigned int cheapestState = UINT_MAX;
+        long long exit = -1;
+        for (unsigned int m = componentStart[c]; m < componentStart[c + 1]; ++m) {
+            const unsigned int s = members[m];
+            unsigned int localMax = 0;
+            for (unsigned int e = graph.firstEdge(s); e < graph.lastEdge(s); ++e) {
+                const unsigned int t = graph.successor(e);
+                if (component[t] == c) {
+                    if (t != s and costs[e] > localMax) {
+                        localMax = costs[e];
+                    }
+                } else if (longest[component[t]] >= 0 and costs[e] + longest[component[t]] > exit) {
+                    exit = costs[e] + longest[component[t]];
+                }
+            }
+            internal += localMax;
+            cheapestState = localMax < cheapestState ? localMax : cheapestState;
+            if (graph.isFinal(s) and exit < 0) {
+                exit = 0;
+            }
+        }
+
+        if (componentStart[c + 1] - componentStart[c] > 1) {
+            internal -= cheapestState;
+            exact = false;
+        } else {
+            internal = 0;
+        }
+
+        if (exit >= 0) {
+            longest[c] = static_cast<long long>(internal) + exit;
+        }
+    }
+
+    status("SCC condensation: %d components, %d states reachable", components, members.size());
+
+    const long long result = longest[component[Tara::initialState]];
+    if (result < 0) {
+        return 0;
+    }
+    return result < UINT_MAX ? static_cast<unsigned int>(result) : UINT_MAX;
+}
+
+
+unsigned int minimalCost() {
+    return minimalCost(Tara::graph.costs());
+}
+
+
+unsigned int minimalCost(const std::vector<unsigned int>& costs) {
+    const InnerGraph& graph = Tara::graph;
+    if (graph.size() == 0) {
+        return 0;
+    }
+
+    // Dijkstra's algorithm up to the first final state
+    typedef std::pair<unsigned long long, unsigned int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    std::vector<unsigned long long> distance(graph.size(), ULLONG_MAX);
+
+    distance[Tara::initialState] = 0;
+    queue.push(Entry(0, Tara::initialState));
+    while (not queue.empty()) {
+        const Entry top = queue.top();
+        queue.pop();
+        const unsigned int s = top.second;
+        if (top.first > distance[s]) {
+            continue;
+        }
+        if (graph.isFinal(s)) {
+            return top.first < UINT_MAX ? static_cast<unsigned int>(top.first) : UINT_MAX;
+        }
+        for (unsigned int e = graph.firstEdge(s); e < graph.lastEdge(s); ++e) {
+            const unsigned long long d = top.first + costs[e];
+            if (d < distance[graph.successor(e)]) {
+                distance[graph.successor(e)] = d;
+                queue.push(Entry(d, graph.successor(e)));
+            }
+        }
+    }
+
+    // no final state is reachable
+    return 0;
+}
+
+
+void cheapestFinalPaths(const std::vector<unsigned int>& costs, std::vector<unsigned long long>& through) {
+    const InnerGraph& graph = Tara::graph;
+    typedef std::pair<unsigned long long, unsigned int> Entry;
+    through.assign(graph.size(), ULLONG_MAX);
+    if (graph.size() == 0) {
+        return;
+    }
+
+    // Dijkstra's algorithm from the initial state
+    std::vector<unsigned long long> distance(graph.size(), ULLONG_MAX);
+    {
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+        distance[Tara::initialState] = 0;
+        queue.push(Entry(0, Tara::initialState));
+        while (not queue.empty()) {
+            const Entry top = queue.top();
+            queue.pop();
+            const unsigned int s = top.second;
+            if (top.first > distance[s]) {
+                continue;
+            }
+            for (unsigned int e = graph.firstEdge(s); e < graph.lastEdge(s); ++e) {
+                const unsigned long long d = top.first + costs[e];
+                if (d < distance[graph.successor(e)]) {
+                    distance[graph.successor(e)] = d;
+                    queue.push(Entry(d, graph.successor(e)));
+                }
+            }
+        }
+    }
+
+    // the reversed edges in the same layout as the graph
+    std::vector<unsigned int> offset(graph.size() + 1, 0);
+    for (unsigned int e = 0; e < graph.edges(); ++e) {
+        ++offset[graph.successor(e) + 1];
+    }
+    for (unsigned int s = 0; s < graph.size(); ++s) {
+        offset[s + 1] += offset[s];
+    }
+    std::vector<unsigned int> predecessor(graph.edges());
+    std::vector<unsigned int> edge(graph.edges());
+    {
+        std::vector<unsigned int> next(offset.begin(), offset.end() - 1);
+        for (unsigned int s = 0; s < graph.size(); ++s) {
+            for (unsigned int e = graph.firstEdge(s); e < graph.lastEdge(s); ++e) {
+                const unsigned int i = next[graph.successor(e)]++;
+                predecessor[i] = s;
+                edge[i] = e;
+            }
+        }
+    }
+
+    // Dijkstra's algorithm backwards from all final states
+    std::vector<unsigned long long> remaining(graph.size(), ULLONG_MAX);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    for (unsigned int s = 0; s < graph.size(); ++s) {
+        if (graph.isFinal(s)) {
+            remaining[s] = 0;
+            queue.push(Entry(0, s));
+        }
+    }
+    while (not queue.empty()) {
+        const Entry top = queue.top();
+        queue.pop();
+        const unsigned int s = top.second;
+        if (top.first > remaining[s]) {
+            continue;
+        }
+        for (unsigned int i = offset[s]; i < offset[s + 1]; ++i) {
+            const unsigned long long d = top.first + costs[edge[i]];
+            if (d < remaining[predecessor[i]]) {
+                remaining[predecessor[i]] = d;
+                queue.push(Entry(d, predecessor[i]));
+            }
+        }
+    }
+
+    for (unsigned int s = 0; s < graph.size(); ++s) {
+        if (distance[s] != ULLONG_MAX and remaining[s] != ULLONG_MAX) {
+            through[s] = distance[s] + remaining[s];
+        }
+    }
+}
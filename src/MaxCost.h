@@ -21,26 +21,32 @@
 #define MAX_COST_H
 
 #include <list>
+#include <vector>
 #include <pnapi/pnapi.h>
 
 // compute the maxCost of the inner Graph
 unsigned int maxCost(pnapi::PetriNet* net);
 
-void printCurrentRun();
+// an upper bound of maxCost in linear time: the inner graph is condensed into
+// its strongly connected components, the costs of a path within a component
+// are bounded, and the longest path through the components is computed
+// exactly; exact is set if no component has more than one state
+unsigned int sccUpperBound(bool& exact);
+
+// the same bound for the given costs of the edges of the inner graph
+unsigned int sccUpperBound(const std::vector<unsigned int>& costs, bool& exact);
+
+// the costs of a cheapest path from the initial state to a final state
+unsigned int minimalCost();
 
-typedef struct {
-    pnapi::Transition *const transition;
-    const unsigned int successor;
-    unsigned int costs;
-} innerTransition;
-
-typedef struct {
-   std::deque<innerTransition> transitions;
-   std::deque<innerTransition>::iterator curTransition;
-   bool inStack;
-   bool final;
-   int curCost;
-   unsigned int maxCosts;
-} innerState;
+// the same costs for the given costs of the edges of the inner graph
+unsigned int minimalCost(const std::vector<unsigned int>& costs);
+
+// for each state, the costs of a cheapest path from the initial state through
+// the state to a final state under the given costs of the edges of the inner
+// graph (ULLONG_MAX if there is no such path)
+void cheapestFinalPaths(const std::vector<unsigned int>& costs, std::vector<unsigned long long>& through);
+
+void printCurrentRun();
 
 #endif
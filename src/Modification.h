@@ -23,6 +23,7 @@
 #include <list>
 #include <pnapi/pnapi.h>
 #include "verbose.h"
+#include "NetTemplate.h"
 
 
 /**
@@ -30,19 +31,39 @@
  */
 class Modification {
    public:
-      Modification() {}; 
-      virtual ~Modification() {};
+      Modification() : owfnTemplate(0) {}; 
+      Modification(const Modification& other) : i(other.i), owfnTemplate(0) {};
+      virtual ~Modification() { delete owfnTemplate; };
 
       virtual unsigned int getI() = 0;
       virtual void setToValue(unsigned int) = 0;
       virtual void init() = 0;
 
+      /// the same modification for a copy of the modified net
+      virtual Modification* clone(pnapi::PetriNet* copy) = 0;
+
       void init(unsigned int newI) {
           i = newI;
           this->init();
+
+          // the structure of the net changed
+          delete owfnTemplate;
+          owfnTemplate = 0;
+      }
+
+      /// writes the modified net under the current value as OWFN; only the
+      /// numbers which depend on the value are written anew for every value
+      void writeOwfn(pnapi::PetriNet& net, FILE* file) {
+          if (owfnTemplate == 0) {
+              owfnTemplate = new NetTemplate(net, *this);
+          }
+          owfnTemplate->write(file, getI());
       }
    protected:
       unsigned int i;
+
+   private:
+      NetTemplate* owfnTemplate;
 };
 
 
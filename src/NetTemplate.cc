@@ -0,0 +1,116 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include "NetTemplate.h"
+#include "Modification.h"
+#include "verbose.h"
+
+namespace {
+    /// the values the net is serialized with; large enough not to be
+    /// confused with other numbers of the net
+    const unsigned int MARKER = 1000000000;
+    const unsigned int DISTANCE = 123456789;
+
+    /// the OWFN text of the net under the given value of the modification
+    std::string serialize(pnapi::PetriNet& net, Modification& modification, unsigned int value) {
+        modification.setToValue(value);
+        std::stringstream ss;
+        ss << pnapi::io::owfn << net << std::flush;
+        return ss.str();
+    }
+}
+
+NetTemplate::NetTemplate(pnapi::PetriNet& net, Modification& modification)
+    : fallback_(false), net_(net) {
+
+    const unsigned int value = modification.getI();
+    const std::string first = serialize(net, modification, MARKER);
+    const std::string second = serialize(net, modification, MARKER + DISTANCE);
+    modification.setToValue(value);
+
+    // compare the texts; a and b are the positions in first and second
+    size_t a = 0;
+    size_t b = 0;
+    size_t pieceStart = 0;
+    while (a < first.size() and b < second.size()) {
+        if (first[a] == second[b]) {
+            ++a;
+            ++b;
+            continue;
+        }
+
+        // the texts differ within a number: find its start and end
+        while (a > pieceStart and isdigit(first[a - 1])) {
+            --a;
+            --b;
+        }
+        size_t endA = a;
+        size_t endB = b;
+        while (endA < first.size() and isdigit(first[endA])) {
+            ++endA;
+        }
+        while (endB < second.size() and isdigit(second[endB])) {
+            ++endB;
+        }
+
+        const long long x = atoll(first.substr(a, endA - a).c_str());
+        const long long y = atoll(second.substr(b, endB - b).c_str());
+        if (endA == a or endB == b or y - x != DISTANCE) {
+            fallback_ = true;
+            break;
+        }
+
+        pieces_.push_back(first.substr(pieceStart, a - pieceStart));
+        offsets_.push_back(x - MARKER);
+        a = endA;
+        b = endB;
+        pieceStart = endA;
+    }
+    if (a != first.size() or b != second.size()) {
+        fallback_ = true;
+    }
+
+    if (fallback_) {
+        status("the modification changes more than numbers; the net is serialized for every check");
+        pieces_.clear();
+        offsets_.clear();
+    } else {
+        pieces_.push_back(first.substr(pieceStart));
+        status("net template: %d bytes, %d numbers to patch", first.size(), offsets_.size());
+    }
+}
+
+void NetTemplate::write(FILE* file, unsigned int value) const {
+    if (fallback_) {
+        // the modification is already set to value
+        std::stringstream ss;
+        ss << pnapi::io::owfn << net_ << std::flush;
+        fprintf(file, "%s", ss.str().c_str());
+        return;
+    }
+
+    for (unsigned int i = 0; i < offsets_.size(); ++i) {
+        fwrite(pieces_[i].data(), 1, pieces_[i].size(), file);
+        fprintf(file, "%lld", value + offsets_[i]);
+    }
+    fwrite(pieces_.back().data(), 1, pieces_.back().size(), file);
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef NET_TEMPLATE_H
+#define NET_TEMPLATE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+
+class Modification;
+
+/**
+ * @brief the OWFN text of a modified net, serialized once and patched for
+ * every value of the modification
+ *
+ * A modification only changes numbers in the text of the net: the token
+ * count of a place or a bound in the final condition. The net is serialized
+ * twice with the modification set to two marker values. Where the texts
+ * differ, they contain a number which follows the value with a constant
+ * offset; the text is cut there, and write() inserts the number for the
+ * value to check. If the texts differ in any other way, the net is
+ * serialized for every value instead.
+ */
+class NetTemplate {
+public:
+    /// serializes the net under two marker values and restores the modification
+    NetTemplate(pnapi::PetriNet& net, Modification& modification);
+
+    /// writes the text of the net under the given value
+    void write(FILE* file, unsigned int value) const;
+
+private:
+    /// the constant parts of the text
+    std::vector<std::string> pieces_;
+
+    /// the numbers between the pieces are value + offset
+    std::vector<long long> offsets_;
+
+    /// set if the texts differ in something else than numbers
+    bool fallback_;
+
+    /// the net, serialized as a whole in the fallback
+    pnapi::PetriNet& net_;
+};
+
+#endif
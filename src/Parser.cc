@@ -5,7 +5,12 @@ int Parser::parse(const char* filename) {
 
     // TODO: check if file exists
 
-    *(this->file)=fopen(filename, "r");
+    return this->parse(fopen(filename, "r"));
+}
+
+int Parser::parse(FILE* stream) {
+
+    *(this->file)=stream;
     int ret=this->yy_parse();
     
     // TODO: line below causes seg-fault :-(
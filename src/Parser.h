@@ -16,6 +16,9 @@ class Parser {
 
        int parse(const char* filename);
 
+       /// parse from an already opened file, e.g. a pipe
+       int parse(FILE* stream);
+
        /// Parser object for Lola output
        static Parser lola;
 
@@ -108,9 +108,9 @@ namespace Reset {
             
 
             // now clone the init marking
-            std::set<pnapi::Place*, bool>::iterator it;
+            pnapi::PetriNet::Places::const_iterator it;
             it = Tara::net->getPlaces().begin();
-            std::set<pnapi::Place*>::iterator end;
+            pnapi::PetriNet::Places::const_iterator end;
             end = Tara::net->getPlaces().end();
             for(; it != end; ++it) {
                 int tokenCount = (*it)->getTokenCount();
@@ -27,9 +27,16 @@
 #include <sstream>
 #include <string>
 #include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
 
 #include <pnapi/pnapi.h>
 #include "Output.h"
+#include "InternalBackend.h"
+#include "VerdictCache.h"
+#include "tinythread.h"
 #include "verbose.h"
 
 
@@ -40,46 +47,158 @@ inline bool fileExists(const std::string& filename) {
 }
 
 
-bool isControllable(pnapi::PetriNet &net, bool useWendyOptimization) {
-    
-    std::string wendyCommand("wendy --correctness=livelock ");
-    if (useWendyOptimization) {
-        wendyCommand+= " --waitstatesOnly --receivingBeforeSending --seqReceivingEvents   --succeedingSendingEvent  --quitAsSoonAsPossible ";
+/// the number of times isControllable asked the backend
+unsigned int controllabilityChecks = 0;
+
+/// guards controllabilityChecks against concurrent checks
+tthread::mutex controllabilityChecksMutex;
+
+unsigned int numberOfControllabilityChecks() {
+    return controllabilityChecks;
+}
+
+
+ControllabilityBackend& ControllabilityBackend::get() {
+    static ControllabilityBackend* backend = 0;
+    if (backend == 0) {
+        switch (Tara::args_info.backend_arg) {
+            case backend_arg_internal: backend = new InternalBackend(); break;
+            default: backend = new WendyBackend(); break;
+        }
+        status("deciding controllability with the %s backend", backend->name());
     }
-    wendyCommand+=" --resultFile="+Tara::tempFile.name();
-    
-//    message("creating a pipe to wendy by calling '%s'", wendyCommand.c_str());
+    return *backend;
+}
 
-    // create stringstream to store the open net
-    std::stringstream ss;
 
-    // ss << pnapi::io::lola << *(net) << std::flush;
-    ss << pnapi::io::owfn << net << std::flush;
-      
-    // call wendy and open a pipe
-    FILE* fp = popen(wendyCommand.c_str(), "w");
+/// runs wendy on the net, which is patched into the template of modification
+/// if given; false if the check was stopped before wendy had a result
+static bool runWendy(pnapi::PetriNet &net, Modification *modification, std::string wendyCommand,
+                     bool &controllable, StoppableCheck *stoppable) {
+    // wendy writes to a result file of this check, so checks may run concurrently
+    Output resultFile;
+    wendyCommand += " --resultFile=" + resultFile.name();
+
+    int input;
+    const pid_t pid = startProcess(wendyCommand, input);
+    if (stoppable != NULL and not stoppable->started(pid)) {
+        kill(-pid, SIGTERM);
+    }
 
     // send the net to wendy
-    fprintf(fp, "%s", ss.str().c_str());
+    FILE* fp = fdopen(input, "w");
+    if (modification != NULL) {
+        modification->writeOwfn(net, fp);
+    } else {
+        std::stringstream ss;
+        ss << pnapi::io::owfn << net << std::flush;
+        fprintf(fp, "%s", ss.str().c_str());
+    }
+    fclose(fp);
 
-    // close the pipe
-    // TODO: is this really the exit status of wendy?
-    // TODO: How we may get the exit code here?
-    int wendyExit=pclose(fp);
+    int wendyExit = 0;
+    waitpid(pid, &wendyExit, 0);
     status("Wendy done with status: %d", wendyExit);
 
-    //if wendy exits with status != 0
-    //TODO add some nice error message here
-    if (wendyExit != 0 ) {
-        message("Wendy returned an error. Exit.");
-	exit(EXIT_FAILURE);
+    const bool failed = not WIFEXITED(wendyExit) or WEXITSTATUS(wendyExit) != 0;
+    if (failed or not readControllability(resultFile.name(), controllable)) {
+        // a stopped wendy has no result; any other failure is an error
+        if (stoppable != NULL and stoppable->stopped()) {
+            return false;
+        }
+        if (failed) {
+            abort(5, "wendy returned an error");
+        }
+        abort(5, "the wendy result file could not be analysed correctly");
+    }
+    return true;
+}
+
+bool checkControllability(pnapi::PetriNet &net, Modification *modification, bool useWendyOptimization,
+                          bool &controllable, StoppableCheck *stoppable) {
+    ControllabilityBackend& backend = ControllabilityBackend::get();
+    const std::string options = backend.options(useWendyOptimization);
+
+    // a warm cache answers without asking the backend
+    std::string cacheKey;
+    if (VerdictCache::isOpen()) {
+        cacheKey = VerdictCache::key(net, modification != NULL ? modification->getI() : 0, options);
+        if (VerdictCache::lookup(cacheKey, controllable)) {
+            status("controllability taken from cache: %s", controllable ? "true" : "false");
+            return true;
+        }
+    }
+
+    {
+        tthread::lock_guard<tthread::mutex> lock(controllabilityChecksMutex);
+        ++controllabilityChecks;
+    }
+
+    if (Tara::args_info.backend_arg != backend_arg_wendy) {
+        // an in-process check is fast enough to never be stopped
+        controllable = backend.check(net, useWendyOptimization);
+    } else if (not runWendy(net, modification, options, controllable, stoppable)) {
+        return false;
+    }
+
+    if (VerdictCache::isOpen()) {
+        VerdictCache::store(cacheKey, controllable);
+    }
+    return true;
+}
+
+bool isControllable(pnapi::PetriNet &net, bool useWendyOptimization) {
+    // the net of Tara is patched into the template of its modification
+    Modification* modification = (&net == Tara::net) ? Tara::modification : NULL;
+    bool controllable;
+    checkControllability(net, modification, useWendyOptimization, controllable);
+    return controllable;
+}
+
+bool isControllable(pnapi::PetriNet &net, Modification &modification, bool useWendyOptimization) {
+    bool controllable;
+    checkControllability(net, &modification, useWendyOptimization, controllable);
+    return controllable;
+}
+
+void computeOG(pnapi::PetriNet &net, std::string outputFile, bool dot) {
+    ControllabilityBackend::get().computeOG(net, outputFile, dot);
+}
+
+/** computes most permissive partner */
+void computeMP(pnapi::PetriNet &net, std::string outputFile, bool dot) {
+
+    // delete existing files...
+    std::remove(outputFile.c_str());
+
+    net.normalize();
+
+    ControllabilityBackend::get().computeMP(net, outputFile, dot);
+}
+
+
+std::string WendyBackend::options(bool useWendyOptimization) const {
+    std::string wendyCommand("wendy --correctness=livelock ");
+    if (useWendyOptimization) {
+        wendyCommand+= " --waitstatesOnly --receivingBeforeSending --seqReceivingEvents   --succeedingSendingEvent  --quitAsSoonAsPossible ";
     }
+    return wendyCommand;
+}
+
+bool WendyBackend::check(pnapi::PetriNet &net, bool useWendyOptimization) {
+    Modification* modification = (&net == Tara::net) ? Tara::modification : NULL;
+    bool controllable;
+    runWendy(net, modification, options(useWendyOptimization), controllable, NULL);
+    return controllable;
+}
 
-    // Check the result file
+
+/// reads the controllability verdict from a wendy result file
+bool readControllability(const std::string &resultFile, bool &controllable) {
     // This could be more general and aware of other versions,
     // if regex were used...
     bool inControllability=false;
-    std::fstream result(Tara::tempFile.name().c_str());
+    std::fstream result(resultFile.c_str());
     std::string line;
     while(getline(result,line)) {
         if(line.compare("controllability: {")==0) {
@@ -87,18 +206,79 @@ bool isControllable(pnapi::PetriNet &net, bool useWendyOptimization) {
         }
 	if(line.compare("};")==0)
 		inControllability=false;
-	if(inControllability && line.compare("  result = true;")==0)
+	if(inControllability && line.compare("  result = true;")==0) {
+		controllable = true;
+		return true;
+	}
+	if(inControllability && line.compare("  result = false;")==0) {
+		controllable = false;
 		return true;
-	if(inControllability && line.compare("  result = false;")==0)
-		return false;
+	}
     }
-    printf("the wendy result file could not be analysed correctly.\n");
-    exit(-1);
     return false;
 }
 
 
-void computeOG(pnapi::PetriNet &net, std::string outputFile, bool dot) {
+/// starts a shell command in a process group of its own, so it can be
+/// killed with all its children; input becomes a pipe to its standard input
+/// and, if output is given, it becomes the read end of a pipe the command
+/// sees as file descriptor 3
+pid_t startProcess(const std::string &command, int &input, int *output) {
+    // processes may be started by several threads; the pipe ends must not
+    // leak into other children, or these keep their standard input open or
+    // the write end of another command's output
+    static tthread::mutex m;
+    tthread::lock_guard<tthread::mutex> lock(m);
+
+    int out[2] = {-1, -1};
+    if (output != NULL) {
+        if (pipe(out) != 0) {
+            abort(5, "could not create a pipe from '%s'", command.c_str());
+        }
+        fcntl(out[0], F_SETFD, FD_CLOEXEC);
+        fcntl(out[1], F_SETFD, FD_CLOEXEC);
+    }
+
+    int in[2];
+    if (pipe(in) != 0) {
+        abort(5, "could not create a pipe to '%s'", command.c_str());
+    }
+    fcntl(in[0], F_SETFD, FD_CLOEXEC);
+    fcntl(in[1], F_SETFD, FD_CLOEXEC);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        abort(5, "could not start '%s'", command.c_str());
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        dup2(in[0], 0);
+        close(in[0]);
+        close(in[1]);
+        if (output != NULL) {
+            if (out[1] != 3) {
+                dup2(out[1], 3);
+                close(out[1]);
+            } else {
+                // already in place; only keep it open across exec
+                fcntl(3, F_SETFD, 0);
+            }
+        }
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*) NULL);
+        _exit(127);
+    }
+
+    close(in[0]);
+    input = in[1];
+    if (output != NULL) {
+        close(out[1]);
+        *output = out[0];
+    }
+    return pid;
+}
+
+
+void WendyBackend::computeOG(pnapi::PetriNet &net, const std::string &outputFile, bool dot) {
     
     std::string wendyCommand("wendy --correctness=livelock ");
     wendyCommand+=" --og="+outputFile;
@@ -124,13 +304,7 @@ void computeOG(pnapi::PetriNet &net, std::string outputFile, bool dot) {
 
 }
 
-/** computes most permissive partner */
-void computeMP(pnapi::PetriNet &net, std::string outputFile, bool dot) {
-
-    // delete existing files...
-    std::remove(outputFile.c_str());
-
-    net.normalize();
+void WendyBackend::computeMP(pnapi::PetriNet &net, const std::string &outputFile, bool dot) {
 
     std::string wendyCommand("wendy --correctness=livelock ");
     wendyCommand += " --sa=" + outputFile;
@@ -201,3 +375,51 @@ void getLolaStatespace(pnapi::PetriNet &net, const std::string &tempFileName) {
     }*/
 
 }
+
+/**
+This function calls lola-statespace with the given net and parses the state
+space with the given parser while lola is still exploring it. The graph is
+handed over by an additional pipe which lola sees as /dev/fd/3, so neither a
+temporary file is written nor has the parser to wait for lola to finish.
+ */
+void streamLolaStatespace(pnapi::PetriNet &net, Parser &parser) {
+
+    std::string command="lola-statespace -m/dev/fd/3";
+
+    time_t start_time;
+    time_t end_time;
+
+    // create stringstream to store the open net
+    std::stringstream ss;
+    ss << pnapi::io::lola << net << std::flush;
+
+    status("creating a pipe to lola by calling '%s'", command.c_str());
+    time(&start_time);
+
+    // lola's output (the state space) is read from a second pipe
+    int input;
+    int output;
+    pid_t pid = startProcess(command, input, &output);
+
+    // send the net to lola; lola reads the whole net before it starts
+    // writing the state space, so this cannot block forever
+    FILE* fp = fdopen(input, "w");
+    fprintf(fp, "%s", ss.str().c_str());
+    fclose(fp);
+
+    // parse the state space as lola writes it
+    FILE* graph = fdopen(output, "r");
+    parser.parse(graph);
+    fclose(graph);
+
+    int lolaExit = 0;
+    waitpid(pid, &lolaExit, 0);
+    time(&end_time);
+
+    if (not WIFEXITED(lolaExit) or WEXITSTATUS(lolaExit) != 0) {
+        abort(5, "lola returned an error");
+    }
+
+    // status message
+    status("lola is done, state space parsed [%.0f sec]", difftime(end_time, start_time));
+}
@@ -22,10 +22,71 @@
 
 #include <pnapi/pnapi.h>
 #include <string>
+#include <sys/types.h>
 #include "Tara.h"
+#include "Modification.h"
+
+/// a tool which decides controllability and computes partners of a net
+class ControllabilityBackend {
+public:
+    virtual ~ControllabilityBackend() {}
+
+    /// the backend selected with --backend
+    static ControllabilityBackend& get();
+
+    virtual const char* name() const = 0;
+
+    /// the options of a check, part of the key of cached verdicts
+    virtual std::string options(bool useWendyOptimization) const = 0;
+
+    /// decides whether the net is controllable
+    virtual bool check(pnapi::PetriNet &net, bool useWendyOptimization) = 0;
+
+    /// writes the most-permissive partner to outputFile, or nothing if there is none
+    virtual void computeMP(pnapi::PetriNet &net, const std::string &outputFile, bool dot) = 0;
+
+    /// writes the operating guideline to outputFile
+    virtual void computeOG(pnapi::PetriNet &net, const std::string &outputFile, bool dot) = 0;
+};
+
+/// calls wendy for every check
+class WendyBackend : public ControllabilityBackend {
+public:
+    const char* name() const { return "wendy"; }
+    std::string options(bool useWendyOptimization) const;
+    bool check(pnapi::PetriNet &net, bool useWendyOptimization);
+    void computeMP(pnapi::PetriNet &net, const std::string &outputFile, bool dot);
+    void computeOG(pnapi::PetriNet &net, const std::string &outputFile, bool dot);
+};
+
+/// lets the caller of a check stop the wendy process it starts
+class StoppableCheck {
+public:
+    virtual ~StoppableCheck() {}
+
+    /// called once wendy runs in process group pid; false stops it right away
+    virtual bool started(pid_t pid) = 0;
+
+    /// whether wendy was stopped, so a missing result is no error
+    virtual bool stopped() = 0;
+};
+
+/// decides whether the net is controllable, patched into the template of
+/// modification if given; verdicts are taken from and added to the verdict
+/// cache. Returns false only if the check was stopped without a result.
+bool checkControllability(pnapi::PetriNet &net, Modification *modification, bool useWendyOptimization,
+                          bool &controllable, StoppableCheck *stoppable = NULL);
 
 bool isControllable(pnapi::PetriNet &net, bool useWendyOptimization=false);
+
+/// decides whether a modified copy of the net is controllable; copies with
+/// modifications of their own may be checked concurrently
+bool isControllable(pnapi::PetriNet &net, Modification &modification, bool useWendyOptimization);
+unsigned int numberOfControllabilityChecks();
+bool readControllability(const std::string &resultFile, bool &controllable);
+pid_t startProcess(const std::string &command, int &input, int *output = NULL);
 void getLolaStatespace(pnapi::PetriNet &net, const std::string &tempFile);
+void streamLolaStatespace(pnapi::PetriNet &net, Parser &parser);
 void computeOG(pnapi::PetriNet &net, std::string outputFile, bool dot = false);
 void computeMP(pnapi::PetriNet &net, std::string outputFile, bool dot = false);
 
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <ctime>
+#include <vector>
 #include "Tara.h"
 
 
@@ -6,26 +9,49 @@ unsigned int Tara::sumOfLocalMaxCosts = 0;
 unsigned int Tara::initialState = 0;
 unsigned int Tara::minCosts = 0; // gna task #7709
 lprec* Tara::lp = 0; 
-int Tara::nrOfEdges = 0;
-int Tara::nrOfFinals = 0;
 std::map<pnapi::Transition*, unsigned int> Tara::partialCostFunction;
+std::map<pnapi::Transition*, unsigned int> Tara::reducedCostFunction;
 std::map<pnapi::Transition*, bool> Tara::resetMap;
 
 pnapi::PetriNet* Tara::net = 0; 
 Modification* Tara::modification = 0; 
+pnapi::PetriNet* Tara::reducedNet = 0;
 
 gengetopt_args_info Tara::args_info;
 
-std::deque<innerState *> Tara::graph;
+InnerGraph Tara::graph;
 
 unsigned int Tara::cost(pnapi::Transition* t) {
    std::map<pnapi::Transition*,unsigned int>::iterator cost = Tara::partialCostFunction.find(t);
-   if(cost==partialCostFunction.end()) 
-      return 0;
+   if(cost==partialCostFunction.end()) {
+      // transitions of the reduced composition replace costly ones
+      cost = Tara::reducedCostFunction.find(t);
+      if(cost==reducedCostFunction.end())
+         return 0;
+   }
 
    return cost->second;
 }
 
+void Tara::randomCostFunction(unsigned int seed) {
+   const pnapi::PetriNet::Transitions& transitions=Tara::net->getTransitions();
+
+   //get argument
+   unsigned int min=(Tara::args_info.minrandomcost_given)?Tara::args_info.minrandomcost_arg:0;
+   unsigned int mod=(Tara::args_info.maxrandomcost_given)?Tara::args_info.maxrandomcost_arg-min+1:101-min;
+   unsigned int cur=0;
+
+   srand(seed);
+
+   for(pnapi::PetriNet::Transitions::const_iterator it=transitions.begin();it!=transitions.end();++it) {
+        //get next rand and pass it to partial cost function
+        cur=min+(rand() % mod);
+        Tara::partialCostFunction[*it]= cur; 
+        if(cur>Tara::highestTransitionCosts) Tara::highestTransitionCosts=cur;
+        status("random costfunction:  %s -> %d", (*it)->getName().c_str(), cur);
+   }
+}
+
 bool Tara::isReset(pnapi::Transition* t) {
    std::map<pnapi::Transition*, bool>::iterator r = Tara::resetMap.find(t);
    if(r == Tara::resetMap.end())  {
@@ -65,6 +91,21 @@ void Tara::evaluateParameters(int argc, char** argv) {
         abort(7, "invalid command-line parameter(s)");
     }
 
+    // the transitions of a reduced composition cannot be resolved against the net
+    if (Tara::args_info.savegraph_given and Tara::args_info.reduce_given) {
+        abort(7, "--savegraph cannot be combined with --reduce");
+    }
+
+    // several cost functions are only evaluated up to the minimal budget
+    if (Tara::args_info.costfunction_given > 1 or Tara::args_info.seeds_given) {
+        if (Tara::args_info.sa_given or Tara::args_info.og_given) {
+            abort(7, "partners cannot be synthesized for several cost functions");
+        }
+        if (Tara::args_info.usecase_given or Tara::args_info.riskcosts_given or Tara::args_info.reduce_given) {
+            abort(7, "several cost functions cannot be combined with --usecase, --riskcosts or --reduce");
+        }
+    }
+
     // debug option
     if (Tara::args_info.bug_flag) {
         {
@@ -117,13 +158,29 @@ void Tara::evaluateParameters(int argc, char** argv) {
     free(params);
 }
 
+/// an edge is taken at most once, either as binary variable or relaxed to [0,1]
+inline void setEdgeVariable(int column) {
+    if (Tara::args_info.lp_arg == lp_arg_relaxed) {
+        set_upbo(Tara::lp, column, 1.0);
+    } else {
+        set_binary(Tara::lp, column, TRUE); /* sets variable to binary */
+    }
+}
+
+/// solves the linear program and returns the time it took
+inline double timedSolve(lprec* lp, int& result) {
+    clock_t start = clock();
+    result = solve(lp);
+    return (static_cast<double>(clock()) - static_cast<double>(start)) / CLOCKS_PER_SEC;
+}
+
 void Tara::constructLP() {
 
     // Number of rows: For each vertex, we include a row -- includes the virtual final vertex
     int NUMBER_OF_ROWS = graph.size() + 1;
 
     // Number of columns: For each edge, we include a column -- includes the virtual edges to the virtual final vertex
-    int NUMBER_OF_COLUMNS = nrOfEdges + nrOfFinals; 
+    int NUMBER_OF_COLUMNS = graph.edges() + graph.finals(); 
 
     lp = make_lp(NUMBER_OF_ROWS, NUMBER_OF_COLUMNS);
     
@@ -133,37 +190,35 @@ void Tara::constructLP() {
 
     for (unsigned int vertexCounter = 0; vertexCounter < graph.size(); ++vertexCounter) {
     
-        innerState* currentVertex = graph[vertexCounter];        
-
-        for (unsigned int edgeCounter = 0; edgeCounter < currentVertex->transitions.size(); ++edgeCounter) {
+        for (unsigned int edge = graph.firstEdge(vertexCounter); edge < graph.lastEdge(vertexCounter); ++edge) {
             REAL sparsecolumn[3]; /* one element per non-zero value -- always exactly three: objective function, source vertex and target vertex. self loops are eliminated while parsing */
             int rowno[3];
 
-            int targetVertex = (int) currentVertex->transitions[edgeCounter].successor + 1;
+            int targetVertex = (int) graph.successor(edge) + 1;
 
             rowno[0] = 0; // objective function
             rowno[1] = vertexCounter + 1; // source vertex
             rowno[2] = targetVertex; // the target vertex row
             
-            sparsecolumn[0] = (REAL) currentVertex->transitions[edgeCounter].costs; // the costs for visiting the edge
+            sparsecolumn[0] = (REAL) graph.costs(edge); // the costs for visiting the edge
             sparsecolumn[1] = -1.0; // a token is taken from the source vertex                
             sparsecolumn[2] = 1.0; // a token is put to the target vertex 
 
-            set_binary(lp, currentEdge, TRUE); /* sets variable to binary */
+            setEdgeVariable(currentEdge);
             unsigned char res = set_columnex(lp, currentEdge, 3, sparsecolumn, rowno); /* changes the values of existing column 2 */
             if (res != TRUE) abort(7,"Could not set the values in the LP."); 
             ++currentEdge;
         }
 
 
-        if (currentVertex->final) {
-            REAL sparsecolumn[1]; /* one element per non-zero value -- always exactly two: current vertex and final vertex. */
-            int rowno[1];
+        if (graph.isFinal(vertexCounter)) {
+            REAL sparsecolumn[2]; /* one element per non-zero value -- always exactly two: current vertex and final vertex. */
+            int rowno[2];
             rowno[0] = vertexCounter + 1;
             sparsecolumn[0] = -1.0;
             rowno[1] = NUMBER_OF_ROWS; // virtual final vertex
             sparsecolumn[1] = +1.0;
-            set_binary(lp, currentEdge, TRUE); /* sets variable to binary */
+            setEdgeVariable(currentEdge);
             unsigned char res = set_columnex(lp, currentEdge, 2, sparsecolumn, rowno); /* changes the values of existing column 2 */ 
             if (res != TRUE) abort(7, "Could not set the values in the LP."); 
             ++currentEdge;
@@ -182,14 +237,42 @@ void Tara::constructLP() {
 }
 
 int Tara::solveLP() {
+    const bool relaxed = (args_info.lp_arg == lp_arg_relaxed);
+    int result;
 
-    solve(lp);
-    int res = get_objective(lp);
+    double seconds = timedSolve(lp, result);
+    status("LP maximization (%s) solved in %.2f sec", relaxed ? "relaxed" : "integer", seconds);
+
+    // without an optimum, fall back to the sound maxout and trivial bounds
+    if (result != OPTIMAL and result != PRESOLVED) {
+        status("LP maximization failed (lp_solve result %d), using maxout and trivial bounds", result);
+        Tara::minCosts = 0;
+        return sumOfLocalMaxCosts;
+    }
+
+    // the costs are integral, so any path is at most the optimum rounded
+    // down; the tolerance only absorbs the floating point error
+    int res = static_cast<int>(floor(get_objective(lp) + 1e-6));
+
+    // warm start the minimization from the optimal basis of the maximization;
+    // the basis stays primal feasible as only the objective changes
+    std::vector<int> basis(1 + get_Nrows(lp) + get_Ncolumns(lp));
+    const bool haveBasis = get_basis(lp, &basis[0], TRUE);
 
     // gna task #7709
     set_minim(lp);
-    solve(lp);
-    int min = get_objective(lp);
+    if (haveBasis) {
+        set_basis(lp, &basis[0], TRUE);
+    }
+    seconds = timedSolve(lp, result);
+    status("LP minimization (%s, %s) solved in %.2f sec", relaxed ? "relaxed" : "integer",
+           haveBasis ? "warm start" : "cold start", seconds);
+
+    int min = 0;
+    if (result == OPTIMAL or result == PRESOLVED) {
+        // rounding up is sound for the same reason as above
+        min = static_cast<int>(ceil(get_objective(lp) - 1e-6));
+    }
     Tara::minCosts = min;
     status("Using LP lower bound: %d", min);
 
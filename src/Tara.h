@@ -11,6 +11,7 @@
 
 #include "Modification.h"
 #include "MaxCost.h"
+#include "InnerGraph.h"
 #include "cmdline.h"
 #include "verbose.h"
 #include "config.h"
@@ -43,6 +44,17 @@ public:
      */
     static std::map<pnapi::Transition* ,unsigned int> partialCostFunction;
 
+    /**
+     * @brief sets the partial cost function to random costs
+     *
+     * The transitions are iterated in the order of the net file, so a seed
+     * always yields the same cost function.
+     */
+    static void randomCostFunction(unsigned int seed);
+
+    /// the costs of the transitions of the reduced composition, see --reduce
+    static std::map<pnapi::Transition* ,unsigned int> reducedCostFunction;
+
     static bool isReset(pnapi::Transition*);
     static std::map<pnapi::Transition* ,bool> resetMap;
 
@@ -52,8 +64,11 @@ public:
     ///the input net
     static Modification* modification;
 
-    /// The actual inner graph, realized by a deque (quick insertion, quick access)
-    static std::deque<innerState *> graph;
+    /// the reduced composition whose state space is parsed, or NULL if not reduced
+    static pnapi::PetriNet* reducedNet;
+
+    /// The actual inner graph, stored in compressed sparse row layout
+    static InnerGraph graph;
 
     ///cmd-line options, see .ggo file for more information
     static gengetopt_args_info args_info;
@@ -66,12 +81,6 @@ public:
     /// The system used if the lp-heuristic is used
     static lprec* lp; 
 
-    /// The number of final states in the inner graph
-    static int nrOfEdges;
-
-    /// The number of edges in the inner graph
-    static int nrOfFinals;
-    
     /// Constructs the linear program from the parsed graph
     static void constructLP();
 
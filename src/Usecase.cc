@@ -21,6 +21,7 @@
 #include <pnapi/pnapi.h>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "Usecase.h"
 #include "verbose.h"
@@ -369,8 +370,16 @@ void Usecase::setToValue(unsigned int newI) {
     i = newI;
 
     if(UC_FASTER) {
-        pnapi::Condition* c = &this->net->getFinalCondition();
-        *c = (*oldFormula) && (*invoice <= i || *finish == 0);
+        // build the condition in one step, as this runs for every budget tried
+        std::vector<const pnapi::formula::Formula*> alternatives;
+        alternatives.push_back(new pnapi::formula::FormulaLessEqual(*invoice, i));
+        alternatives.push_back(new pnapi::formula::FormulaEqual(*finish, 0));
+
+        std::vector<const pnapi::formula::Formula*> conjuncts;
+        conjuncts.push_back(oldFormula->clone());
+        conjuncts.push_back(new pnapi::formula::Disjunction(alternatives));
+
+        net->getFinalCondition() = pnapi::formula::Conjunction(conjuncts);
     }
 
     if(!UC_FASTER) {
@@ -379,3 +388,22 @@ void Usecase::setToValue(unsigned int newI) {
 
     // std::cout << pnapi::io::owfn << *net;
 }
+
+Modification* Usecase::clone(pnapi::PetriNet* copy) {
+    Usecase* result = new Usecase(*this);
+
+    // the nodes of the copy have the same names
+    std::map<const pnapi::Place*, const pnapi::Place*> placeMap;
+    std::set<pnapi::Place*> places = net->getPlaces();
+    for(std::set<pnapi::Place*>::iterator it = places.begin(); it != places.end(); ++it) {
+        placeMap[*it] = copy->findPlace((*it)->getName());
+    }
+
+    result->net = copy;
+    result->credit = copy->findPlace(credit->getName());
+    result->invoice = copy->findPlace(invoice->getName());
+    result->finish = copy->findPlace(finish->getName());
+    result->pay_for_invoice = copy->findTransition(pay_for_invoice->getName());
+    result->oldFormula = oldFormula->clone(&placeMap);
+    return result;
+}
@@ -19,6 +19,7 @@ class Usecase : public Modification {
 
         virtual unsigned int getI();
         virtual void setToValue(unsigned int i);
+        virtual Modification* clone(pnapi::PetriNet* copy);
 
     private:
         pnapi::PetriNet* net;
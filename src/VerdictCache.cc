@@ -0,0 +1,184 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "VerdictCache.h"
+#include "verbose.h"
+
+std::map<std::string, bool> VerdictCache::verdicts;
+std::string VerdictCache::filename;
+tthread::mutex VerdictCache::mutex;
+
+namespace {
+
+/// 64 bit FNV-1a hash
+uint64_t fnv(const std::string& s, uint64_t h = 14695981039346656037ULL) {
+    for (unsigned int i = 0; i < s.size(); ++i) {
+        h = (h ^ (unsigned char) s[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string toHex(uint64_t h) {
+    char buffer[17];
+    sprintf(buffer, "%08x%08x", (unsigned int) (h >> 32), (unsigned int) h);
+    return buffer;
+}
+
+/// a description of a formula with the children of operators in sorted order
+std::string describe(const pnapi::formula::Formula& f) {
+    using namespace pnapi::formula;
+    std::stringstream s;
+
+    switch (f.getType()) {
+        case Formula::F_TRUE: return "true";
+        case Formula::F_FALSE: return "false";
+        case Formula::F_NEGATION:
+        case Formula::F_CONJUNCTION:
+        case Formula::F_DISJUNCTION: {
+            const std::set<const Formula*>& children = static_cast<const Operator&>(f).getChildren();
+            std::vector<std::string> descriptions;
+            for (std::set<const Formula*>::const_iterator c = children.begin(); c != children.end(); ++c) {
+                descriptions.push_back(describe(**c));
+            }
+            std::sort(descriptions.begin(), descriptions.end());
+
+            s << (f.getType() == Formula::F_NEGATION ? "NOT" : (f.getType() == Formula::F_CONJUNCTION ? "AND" : "OR")) << "(";
+            for (unsigned int i = 0; i < descriptions.size(); ++i) {
+                s << descriptions[i] << ";";
+            }
+            s << ")";
+            return s.str();
+        }
+        default: {
+            const Proposition& p = static_cast<const Proposition&>(f);
+            s << p.getPlace().getName() << " " << f.getType() << " " << p.getTokens();
+            return s.str();
+        }
+    }
+}
+
+} // anonymous namespace
+
+void VerdictCache::open(const std::string& file) {
+    tthread::lock_guard<tthread::mutex> lock(mutex);
+    filename = file;
+
+    std::ifstream in(filename.c_str());
+    std::string key;
+    int verdict;
+    while (in >> key >> verdict) {
+        verdicts[key] = (verdict != 0);
+    }
+    status("read %d controllability verdicts from cache '%s'", verdicts.size(), filename.c_str());
+}
+
+bool VerdictCache::isOpen() {
+    return not filename.empty();
+}
+
+std::string VerdictCache::key(const pnapi::PetriNet& net, unsigned int budget,
+                              const std::string& options) {
+    std::stringstream s;
+    s << hash(net) << "-" << budget << "-" << toHex(fnv(options));
+    return s.str();
+}
+
+bool VerdictCache::lookup(const std::string& key, bool& controllable) {
+    tthread::lock_guard<tthread::mutex> lock(mutex);
+    std::map<std::string, bool>::const_iterator it = verdicts.find(key);
+    if (it == verdicts.end()) {
+        return false;
+    }
+    controllable = it->second;
+    return true;
+}
+
+void VerdictCache::store(const std::string& key, bool controllable) {
+    tthread::lock_guard<tthread::mutex> lock(mutex);
+    if (verdicts.find(key) != verdicts.end()) {
+        return;
+    }
+    verdicts[key] = controllable;
+
+    std::ofstream out(filename.c_str(), std::ios_base::app);
+    out << key << " " << (controllable ? 1 : 0) << std::endl;
+    if (not out.good()) {
+        message("could not write to cache file '%s'", filename.c_str());
+    }
+}
+
+std::string VerdictCache::hash(const pnapi::PetriNet& net) {
+    std::vector<std::string> elements;
+
+    PNAPI_FOREACH(p, net.getPlaces()) {
+        std::stringstream s;
+        s << "P " << (*p)->getName() << " " << (*p)->getTokenCount() << " " << (*p)->getCapacity();
+        elements.push_back(s.str());
+    }
+
+    PNAPI_FOREACH(t, net.getTransitions()) {
+        std::stringstream s;
+        s << "T " << (*t)->getName();
+        std::vector<std::string> labels;
+        PNAPI_FOREACH(l, (*t)->getLabels()) {
+            std::stringstream label;
+            label << l->first->getName() << "*" << l->second;
+            labels.push_back(label.str());
+        }
+        std::sort(labels.begin(), labels.end());
+        for (unsigned int i = 0; i < labels.size(); ++i) {
+            s << " " << labels[i];
+        }
+        elements.push_back(s.str());
+    }
+
+    PNAPI_FOREACH(a, net.getArcs()) {
+        std::stringstream s;
+        s << "A " << (*a)->getSourceNode().getName() << " " << (*a)->getTargetNode().getName() << " " << (*a)->getWeight();
+        elements.push_back(s.str());
+    }
+
+    PNAPI_FOREACH(port, net.getInterface().getPorts()) {
+        PNAPI_FOREACH(l, net.getInterface().getInputLabels(*port->second)) {
+            elements.push_back("I " + port->first + " " + (*l)->getName());
+        }
+        PNAPI_FOREACH(l, net.getInterface().getOutputLabels(*port->second)) {
+            elements.push_back("O " + port->first + " " + (*l)->getName());
+        }
+        PNAPI_FOREACH(l, net.getInterface().getSynchronousLabels(*port->second)) {
+            elements.push_back("S " + port->first + " " + (*l)->getName());
+        }
+    }
+
+    elements.push_back("F " + describe(net.getFinalCondition().getFormula()));
+
+    std::sort(elements.begin(), elements.end());
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned int i = 0; i < elements.size(); ++i) {
+        h = fnv(elements[i] + "\n", h);
+    }
+    return toHex(h);
+}
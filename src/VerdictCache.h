@@ -0,0 +1,72 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+#ifndef VERDICT_CACHE_H
+#define VERDICT_CACHE_H
+
+#include <map>
+#include <string>
+#include <pnapi/pnapi.h>
+#include "tinythread.h"
+
+/**
+ * @brief on-disk cache of controllability verdicts
+ *
+ * A verdict is stored under a key consisting of a canonical hash of the
+ * (modified) net, the budget and the options passed to wendy. The cache file
+ * holds one "key verdict" line per verdict; new verdicts are appended as soon
+ * as they are known, so an interrupted run still fills the cache.
+ */
+class VerdictCache {
+public:
+    /// loads the verdicts of the given file and appends new verdicts to it
+    static void open(const std::string& filename);
+
+    /// whether a cache file is used
+    static bool isOpen();
+
+    /// the key for checking net under budget with the given wendy options
+    static std::string key(const pnapi::PetriNet& net, unsigned int budget,
+                           const std::string& options);
+
+    /// looks up a verdict; returns false if the key is unknown
+    static bool lookup(const std::string& key, bool& controllable);
+
+    /// stores a verdict in memory and in the cache file
+    static void store(const std::string& key, bool controllable);
+
+    /**
+     * @brief a hash of the net which does not depend on the order of its
+     * nodes in memory: the nodes, arcs, interface and final condition are
+     * described by their names, sorted, and hashed as a whole
+     */
+    static std::string hash(const pnapi::PetriNet& net);
+
+private:
+    /// the known verdicts
+    static std::map<std::string, bool> verdicts;
+
+    /// the cache file
+    static std::string filename;
+
+    /// guards the verdicts and the cache file
+    static tthread::mutex mutex;
+};
+
+#endif
@@ -21,17 +21,23 @@
 #include <list>
 #include <pnapi/pnapi.h>
 #include <stdio.h>
+#include <vector>
 #include "verbose.h"
 #include "Tara.h"
 
 // create the modification based on the net
 iModification::iModification(pnapi::PetriNet* netToModify)
-   : net(netToModify)
+   : net(netToModify), costFunction(NULL), highestCosts(Tara::highestTransitionCosts)
 {
    // do the init modification
    // this->init();
 } 
 
+iModification::iModification(pnapi::PetriNet* netToModify, const std::map<pnapi::Transition*, unsigned int>& costs)
+   : net(netToModify), costFunction(&costs), highestCosts(0)
+{
+}
+
 void iModification::iterate() {
    
    decrease();
@@ -47,7 +53,7 @@ void iModification::iterate() {
 void iModification::update() {
     
    // update the available costs
-   availableCost->setTokenCount(Tara::highestTransitionCosts+i);
+   availableCost->setTokenCount(highestCosts+i);
         
 
 }
@@ -88,9 +94,27 @@ unsigned int iModification::increase() {
   
 unsigned int iModification::getI() { return this->i; }
 
+Modification* iModification::clone(pnapi::PetriNet* copy) {
+   iModification* result = new iModification(copy);
+   result->i = i;
+   result->highestCosts = highestCosts;
+   // the copy has a place of the same name
+   result->availableCost = copy->findPlace(availableCost->getName());
+   return result;
+}
+
 void iModification::init() {
 
-   status("Initializing modification. Highest transition costs are: %d", Tara::highestTransitionCosts);
+   if (costFunction == NULL) {
+      highestCosts = Tara::highestTransitionCosts;
+   } else {
+      highestCosts = 0;
+      for (std::map<pnapi::Transition*, unsigned int>::const_iterator it = costFunction->begin(); it != costFunction->end(); ++it) {
+         highestCosts = it->second > highestCosts ? it->second : highestCosts;
+      }
+   }
+
+   status("Initializing modification. Highest transition costs are: %d", highestCosts);
    status("max i is: %d", this->i);
 
    //create the place for the availble costs
@@ -100,17 +124,22 @@ void iModification::init() {
 
   
    //iterate over all transitions of the net
-   std::set<pnapi::Transition*> allTransitions=net->getTransitions();
-   for(std::set<pnapi::Transition*>::iterator it=allTransitions.begin();it!=allTransitions.end();++it) {
+   const pnapi::PetriNet::Transitions& allTransitions=net->getTransitions();
+   for(pnapi::PetriNet::Transitions::const_iterator it=allTransitions.begin();it!=allTransitions.end();++it) {
 
       // the cost of that transition
-      int curCost = Tara::cost(*it);
+      int curCost = 0;
+      if (costFunction == NULL) {
+         curCost = Tara::cost(*it);
+      } else if (costFunction->find(*it) != costFunction->end()) {
+         curCost = costFunction->find(*it)->second;
+      }
 
       unsigned int in = 0;
       unsigned int out = 0;
 		
-     in = Tara::highestTransitionCosts;
-	 out = Tara::highestTransitionCosts - curCost;
+     in = highestCosts;
+	 out = highestCosts - curCost;
      
 	 //add arc from availableCost to that transition
 	 if (in > 0) net->createArc(*availableCost, **it, in);
@@ -120,7 +149,10 @@ void iModification::init() {
 
    }
    
-   net->getFinalCondition() = (net->getFinalCondition().getFormula() && ( *availableCost >= Tara::highestTransitionCosts ));
+   std::vector<const pnapi::formula::Formula*> conjuncts;
+   conjuncts.push_back(net->getFinalCondition().getFormula().clone());
+   conjuncts.push_back(new pnapi::formula::FormulaGreaterEqual(*availableCost, highestCosts));
+   net->getFinalCondition() = pnapi::formula::Conjunction(conjuncts);
    // finally set the availble costs
-   this->availableCost->setTokenCount(Tara::highestTransitionCosts+i);
+   this->availableCost->setTokenCount(highestCosts+i);
 }
@@ -21,6 +21,7 @@
 #define I_MODIFICATION_H
 
 #include <list>
+#include <map>
 #include <pnapi/pnapi.h>
 #include "Modification.h"
 
@@ -33,9 +34,16 @@ class iModification : public Modification {
 
    public:
       iModification(pnapi::PetriNet*);
+
+      /// the modification for a cost function of the transitions of the net,
+      /// instead of the one of Tara
+      iModification(pnapi::PetriNet*, const std::map<pnapi::Transition*, unsigned int>&);
+
       virtual void init();
+      using Modification::init;
       virtual unsigned int getI();
       virtual void setToValue(unsigned int);
+      virtual Modification* clone(pnapi::PetriNet*);
 
       //TODO: these arent used ???
       void iterate();
@@ -49,6 +57,12 @@ class iModification : public Modification {
       pnapi::PetriNet* net;
       // unsigned int i;
 
+      /// the cost function, or NULL for the one of Tara
+      const std::map<pnapi::Transition*, unsigned int>* costFunction;
+
+      /// the costs of the most expensive transition, set by init
+      unsigned int highestCosts;
+
 
       pnapi::Place* availableCost;
       pnapi::Arc* outOfCreditArc;
@@ -26,10 +26,15 @@
 
 %{
 #include <cstring>
+#include <pnapi/pnapi.h>
 #include "syntax_graph.hh"
+#include "FinalCondition.h"
+#include "Tara.h"
 #include "verbose.h"
 
 void graph_error(const char*);
+
+extern FinalCondition* finalCondition;
 %}
 
 name      [^,;:()\t \n\{\}][^,;:()\t \n\{\}]*
@@ -47,7 +52,13 @@ number    [0-9][0-9]*
 "->"         { return ARROW; }
 
 {number}     { graph_lval.val = atoi(graph_text); return NUMBER; }
-{name}       { graph_lval.str = strdup(graph_text); return NAME; }
+{name}       { /* places and transitions of the net are resolved right away */
+               graph_lval.val = finalCondition->findPlace(graph_text, graph_leng);
+               if (graph_lval.val != FinalCondition::NO_PLACE) {
+                 return PLACE;
+               }
+               graph_lval.transition = (Tara::reducedNet != NULL ? Tara::reducedNet : Tara::net)->findTransition(graph_text, graph_leng);
+               return NAME; }
 
 [ \t\r\n]*   { /* skip */ }
 
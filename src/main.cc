@@ -41,6 +41,13 @@
 #include "CCSearch.h"
 #include "Risk.h"
 #include "Reset.h"
+#include "CostReduction.h"
+#include "GraphScanner.h"
+#include "GraphSnapshot.h"
+#include "tinythread.h"
+#include "VerdictCache.h"
+#include "BudgetSearch.h"
+#include "CostBatch.h"
 
 using std::cerr;
 using std::cout;
@@ -76,6 +83,11 @@ int main(int argc, char** argv) {
     Output::setTempfileTemplate(Tara::args_info.tmpfile_arg);
     Output::setKeepTempfiles(Tara::args_info.noClean_flag);
 
+    // use the cache of controllability verdicts
+    if (Tara::args_info.cache_given) {
+        VerdictCache::open(Tara::args_info.cache_arg);
+    }
+
     // set the function to call on normal termination
     atexit(terminationHandler);
     /*----------------------------.
@@ -109,20 +121,21 @@ int main(int argc, char** argv) {
     | 2. Parse Costfunction to partial map |
     \-------------------------------------*/
 
-    message("Step 2: Parse the cost function from '%s' and apply it to the built statespace", Tara::args_info.costfunction_arg);
+    if (CostBatch::requested()) {
+        message("Step 2: Parse the cost functions and apply each of them to the built statespace");
+    } else {
+        message("Step 2: Parse the cost function from '%s' and apply it to the built statespace", Tara::args_info.costfunction_arg[0]);
+    }
 
     status("parsing costfunction");
-    if (strcmp(Tara::args_info.costfunction_arg, "-r") != 0) {
-	    Parser::costfunction.parse(Tara::args_info.costfunction_arg);
+    if (CostBatch::requested()) {
+        CostBatch::parse();
+    }
+    else if (strcmp(Tara::args_info.costfunction_arg[0], "-r") != 0) {
+	    Parser::costfunction.parse(Tara::args_info.costfunction_arg[0]);
     }
     else {  // if costfunction should be random
        status("generating random costfunction");
-       const std::set<pnapi::Transition*> transitions=Tara::net->getTransitions();
-   
-       //get argument
-       unsigned int min=(Tara::args_info.minrandomcost_given)?Tara::args_info.minrandomcost_arg:0;
-       unsigned int mod=(Tara::args_info.maxrandomcost_given)?Tara::args_info.maxrandomcost_arg-min+1:101-min;
-       unsigned int cur=0;
 
        //seed rand
        bool seedGiven=Tara::args_info.randomseed_given;
@@ -132,15 +145,7 @@ int main(int argc, char** argv) {
        else
 	       seed=time(NULL);
 
-       srand(seed);
-
-       for(std::set<pnapi::Transition*>::iterator it=transitions.begin();it!=transitions.end();++it) {
-            //get next rand and pass it to partial cost function
-            cur=min+(rand() % mod);
-            Tara::partialCostFunction[*it]= cur; 
-            if(cur>Tara::highestTransitionCosts) Tara::highestTransitionCosts=cur;
-            status("random costfunction:  %s -> %d", (*it)->getName().c_str(), cur);
-       }
+       Tara::randomCostFunction(seed);
     }
     if (Tara::args_info.riskcosts_given) {
         status("risk costs given with base %d", Tara::args_info.riskcosts_given);
@@ -149,8 +154,8 @@ int main(int argc, char** argv) {
 
     if(Tara::args_info.inputdot_given) {
         pnapi::PetriNet inputdotnet = *Tara::net;
-        const std::set<pnapi::Transition*> transitions=inputdotnet.getTransitions();
-        for(std::set<pnapi::Transition*>::iterator it=transitions.begin();it!=transitions.end();++it) {
+        const pnapi::PetriNet::Transitions& transitions=inputdotnet.getTransitions();
+        for(pnapi::PetriNet::Transitions::const_iterator it=transitions.begin();it!=transitions.end();++it) {
           std::stringstream s;
           pnapi::Transition* t = Tara::net->findTransition((*it)->getName());
           // add cost in brackets to name
@@ -174,6 +179,22 @@ int main(int argc, char** argv) {
         inputdotFile.close();
     }
 
+    if (Tara::args_info.automaton_given) {
+        const unsigned int threads = Tara::args_info.automatonthreads_arg > 0 ? Tara::args_info.automatonthreads_arg : tthread::thread::hardware_concurrency();
+        status("building the reachability graph of the net with %d threads", threads);
+        pnapi::Automaton automaton(*Tara::net, threads > 0 ? threads : 1, not Tara::args_info.discoveryorder_flag);
+
+        if (std::string(Tara::args_info.automaton_arg).compare("-") != 0) {
+            std::ofstream automatonFile(Tara::args_info.automaton_arg);
+            if (not automatonFile) {
+                abort(11, "could not write to file '%s'", Tara::args_info.automaton_arg);
+            }
+            automatonFile << pnapi::io::sa << automaton;
+        } else {
+            cout << pnapi::io::sa << automaton;
+        }
+    }
+
     if (Tara::resetMap.size() > 0) {
         status("transforming %d Reset- Transitions", Tara::resetMap.size());
         Reset::transformNet();
@@ -183,23 +204,29 @@ int main(int argc, char** argv) {
     | 2. get most permissive Partner MP |
     `----------------------------------*/
 
-    computeMP(*Tara::net, Tara::tempFile.name(), false);
-     
+    // a loaded inner graph needs neither the partner nor the composition
+    const bool loadGraph = Tara::args_info.loadgraph_given;
+
     // first create automaton partner
     pnapi::Automaton partner;
     std::ifstream partnerStream;
 
-    //stream automaton
-    partnerStream.open(Tara::tempFile.name().c_str(), std::ifstream::in);
-    if(!partnerStream) {
-        message("net is not controllable. Exit.");
-        exit(EXIT_FAILURE);
-    }
+    if (not loadGraph) {
+        computeMP(*Tara::net, Tara::tempFile.name(), false);
 
-    partnerStream >> pnapi::io::sa >> partner;
+        //stream automaton
+        partnerStream.open(Tara::tempFile.name().c_str(), std::ifstream::in);
+        if(!partnerStream) {
+            message("net is not controllable. Exit.");
+            exit(EXIT_FAILURE);
+        }
+
+        partnerStream >> pnapi::io::sa >> partner;
+    }
     
     // convert to petri net
-    pnapi::PetriNet composition(partner);
+    pnapi::PetriNet partnerNet(partner);
+    pnapi::PetriNet composition;
 
     /*---------------------.
     | 3. set modification  |
@@ -242,44 +269,102 @@ int main(int argc, char** argv) {
     | 5. Compute cost bound |
     `----------------------*/
     
-    // compose
-    try {
-        composition.compose(*Tara::net, "mpp-", "");
-	} catch (pnapi::exception::Error error) {
-		std::stringstream inputerror;
-		inputerror << error;
-		abort(3, "pnapi error %s", inputerror.str().c_str());
-	} 
+    // keep what is needed to apply other cost functions to the graph
+    if (Tara::args_info.savegraph_given or CostBatch::requested()) {
+        Tara::graph.keepParallelTransitions();
+    }
 
-    /*--------------------------.
-    | 5.1. call lola with n+mp  |
-    `--------------------------*/
-    message("Step 2: Build the state space of '%s' and its most-permissive partner", Tara::args_info.net_arg);    
+    if (loadGraph) {
+        message("Step 2: Load the state space of '%s' and its most-permissive partner from '%s'", Tara::args_info.net_arg, Tara::args_info.loadgraph_arg);
+        GraphSnapshot::load(Tara::args_info.loadgraph_arg);
+    } else {
+        // compose
+        try {
+            // built in place, so the composition is not copied
+            partnerNet.compose(*Tara::net, "mpp-", "", composition);
+        } catch (pnapi::exception::Error error) {
+            std::stringstream inputerror;
+            inputerror << error;
+            abort(3, "pnapi error %s", inputerror.str().c_str());
+        }
+
+        // reduce the composition before its state space is built
+        if (Tara::args_info.reduce_given) {
+            status("reducing the composition");
+            CostReduction::reduceComposition(composition);
+        }
+
+        /*--------------------------.
+        | 5.1. call lola with n+mp  |
+        `--------------------------*/
+        message("Step 2: Build the state space of '%s' and its most-permissive partner", Tara::args_info.net_arg);    
+
+        if (Tara::args_info.streaming_flag) {
+            // run lola-statespace and parse the inner graph while it is built
+            status("parsing inner graph from lola's output stream");
+            streamLolaStatespace(composition, Parser::lola);
+        } else {
+            // run lola-statespace from the service tools
+            getLolaStatespace(composition,Tara::tempFile.name());
+
+            /*--------------------------.
+            | 5.2 Parse the inner Graph |
+            \--------------------------*/
+            status("parsing inner graph");
+            unsigned int threads = 1;
+            if (Tara::args_info.parsethreads_given) {
+                threads = Tara::args_info.parsethreads_arg > 0 ? Tara::args_info.parsethreads_arg : tthread::thread::hardware_concurrency();
+            }
+            GraphScanner(Tara::reducedNet != NULL ? *Tara::reducedNet : *Tara::net).scan(Tara::tempFile.name(), threads);
+        }
+    }
+
+    if (Tara::args_info.savegraph_given) {
+        GraphSnapshot::save(Tara::args_info.savegraph_arg);
+    }
 
-    // run lola-statespace from the service tools
-    getLolaStatespace(composition,Tara::tempFile.name());
+    status("inner graph has %d states and %d edges", Tara::graph.size(), Tara::graph.edges());
+    if(Tara::args_info.stats_flag and Tara::graph.size() > 0) {
+        message("inner graph: %d states, %d edges, %.1f bytes per state",
+            Tara::graph.size(), Tara::graph.edges(),
+            static_cast<double>(Tara::graph.memoryUsage()) / Tara::graph.size());
+    }
 
-    /*--------------------------.
-    | 5.2 Parse the inner Graph |
-    \--------------------------*/
-    status("parsing inner graph");
-    Parser::lola.parse(Tara::tempFile.name().c_str()); 
+    // every cost function gets its own bounds and minimal budget
+    if (CostBatch::requested()) {
+        unsigned int threads = tthread::thread::hardware_concurrency();
+        if (Tara::args_info.batchthreads_given and Tara::args_info.batchthreads_arg > 0) {
+            threads = Tara::args_info.batchthreads_arg;
+        }
+        message("Step 4: Find the minimal budgets w.r.t. Tara::net '%s' and %d cost functions", Tara::args_info.net_arg, CostBatch::size());
+        CostBatch::evaluate(threads > 0 ? threads : 1);
+        CostBatch::print(stdout);
+        return EXIT_SUCCESS;
+    }
 
     /*--------------------------------------------.
     | 5.3. Compute MaxCosts from the parsed graph | 
     \--------------------------------------------*/
-    message("Step 4: Find an upper bound for the minimal budget w.r.t. Tara::net '%s' and cost function '%s'", Tara::args_info.net_arg, Tara::args_info.costfunction_arg);    
+    message("Step 4: Find an upper bound for the minimal budget w.r.t. Tara::net '%s' and cost function '%s'", Tara::args_info.net_arg, Tara::args_info.costfunction_arg[0]);    
 
     // max Costs are the costs of the most expensive path through
     // the inner state graph
     
-    unsigned int maxCostOfComposition=maxCost(Tara::net);
+    // the transitions of a reduced composition may cost more than any one of the net
+    unsigned int maxCostOfComposition=maxCost(Tara::reducedNet != NULL ? Tara::reducedNet : Tara::net);
     status("max cost of composition bound: %d", maxCostOfComposition);
 
     /*------------------------------------------.
     | 7. Find a corresponding partner           | 
     \------------------------------------------*/
 
+    // the most-permissive partner is returned if the costs are unbounded;
+    // with a loaded graph, it has to be computed before the net is modified
+    if (loadGraph and Tara::args_info.sa_given and not Tara::args_info.dot_given) {
+        computeMP(*Tara::net, Tara::tempFile.name(), false);
+        partnerStream.open(Tara::tempFile.name().c_str(), std::ifstream::in);
+    }
+
     // Build the modified Tara::net for maxCostOfComposition
     //Modification* modification = new iModification(Tara::net, maxCostOfComposition);
     Tara::modification->init(maxCostOfComposition);
@@ -333,30 +418,24 @@ int main(int argc, char** argv) {
             if(USE_CONCURRENCY) {
                 status("Step 5: Find minimal budget with concurrent search");
                 // run the experimental conccurrent search for comparison with correct result
-                CCSearch::setBounds(0,maxCostOfComposition);
+                CCSearch::setBounds(Tara::minCosts,maxCostOfComposition);
                 minBudget=CCSearch::search();
             }
             else {
 
-                status("Step 5: Find the minimal budget with a binary search");
+                BudgetSearch* budgetSearch = BudgetSearch::create(Tara::minCosts, maxCostOfComposition); // gna task #7709
+                status("Step 5: Find the minimal budget with a %s search", budgetSearch->name());
 
-                int bsUpper = maxCostOfComposition-1; // for maxCostofComposition, it is controllable anyway. 
-                int bsLower = Tara::minCosts; // gna task #7709
-            
-                while (bsLower <= bsUpper) {
-                   
-                    // Set the new budget to the middle of the interval
-                    Tara::modification->setToValue((bsLower + bsUpper) / 2);
-                        
-                    status("Checking budget %d (lower bound: %d, upper bound: %d)", Tara::modification->getI(), bsLower, bsUpper);
-                    bool bsControllable = isControllable(*Tara::net, true);
-                    if (bsControllable) {
-                        minBudget = Tara::modification->getI();
-                        bsUpper = Tara::modification->getI() - 1;
-                    } else {
-                        bsLower = Tara::modification->getI() + 1;
-                    }
+                // the check of the upper bound above is no probe of the search
+                const unsigned int boundChecks = numberOfControllabilityChecks();
+
+                // for maxCostofComposition, it is controllable anyway. 
+                minBudget = budgetSearch->search();
+
+                if (Tara::args_info.stats_flag) {
+                    message("budget search (%s): %d budgets checked, %d %s calls, %d more for the upper bound", budgetSearch->name(), budgetSearch->probes(), numberOfControllabilityChecks() - boundChecks, ControllabilityBackend::get().name(), boundChecks);
                 }
+                delete budgetSearch;
             }
         } 
 
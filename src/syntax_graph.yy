@@ -23,7 +23,7 @@ NOTE: This syntax-scanner does not recognize semantic errors!
 Wrong Input causes undefined behaviour and not necessarily an error message.
 */
 
-%token KW_STATE KW_LOWLINK KW_SCC COLON COMMA ARROW NUMBER NAME
+%token KW_STATE KW_LOWLINK KW_SCC COLON COMMA ARROW NUMBER NAME PLACE
 
 %expect 0
 %defines
@@ -34,59 +34,69 @@ Wrong Input causes undefined behaviour and not necessarily an error message.
 #include <stdio.h>
 #include <pnapi/pnapi.h>
 #include <map>
+#include <vector>
+#include <climits>
 #include <set>
 #include <list>
 #include <algorithm>
 #include <utility>
 #include "Tara.h"
 #include "MaxCost.h"
+#include "FinalCondition.h"
+#include "LolaStateMap.h"
 #include "verbose.h"
 
 extern int graph_lex();
 extern int graph_error(const char *);
 
-/// current marking of the PN API net; for finding final states
-std::map<const pnapi::Place*, unsigned int> currentMarking;
+/// the compiled final condition of the net; also resolves place names for the lexer
+FinalCondition* finalCondition = NULL;
+
+/// current marking of the PN API net, indexed by place number; for finding final states
+std::vector<unsigned int> currentMarking;
+
+/// the places marked in the current marking, to reset it for the next state
+std::vector<unsigned int> markedPlaces;
 
 ///currentState during parsing
 unsigned int currentState;
 unsigned int currentTaraState;
 
-// A mapping from the lola state numbers to the actual state numbers
-std::map<const unsigned int, unsigned int> lolaToTara;
-
-unsigned int getTaraState (unsigned int lolaState) {
-    // First check whether the lola state has been seen yet
-    
-    std::map<const unsigned int, unsigned int>::iterator it =  lolaToTara.find(lolaState);
-    bool seen = (it != lolaToTara.end());
-    
-    // If the state has been seen, return the value
-    if (seen) {
-        return it->second;
-    } 
-    
-    // Otherwise: Create a new state, store the value, return it.
-    unsigned int taraState = Tara::graph.size();
-    Tara::graph.push_back(new innerState);
-    Tara::graph.back()->maxCosts = 0;
-    lolaToTara[lolaState] = taraState;
-    return taraState;
-}
+/// maps the lola state numbers to the states of the inner graph
+LolaStateMap lolaToTara(Tara::graph);
 
 %}
 
+%initial-action {
+    // compile the final condition once for all states; the reduced
+    // composition carries the final condition of the net
+    delete finalCondition;
+    finalCondition = new FinalCondition(Tara::reducedNet != NULL ? *Tara::reducedNet : *Tara::net);
+    currentMarking.assign(finalCondition->places(), 0);
+    markedPlaces.clear();
+}
+
 %union {
   unsigned int val;
-  char* str;
+  pnapi::Transition* transition;
 }
 
 %type <val> NUMBER
-%type <str> NAME
+%type <val> PLACE
+%type <transition> NAME
 %type <val> lowlink
 
 %%
 
+graph:
+  states
+    {
+    // build the offset array once all states are known
+    Tara::graph.finalize();
+    Tara::sumOfLocalMaxCosts = Tara::graph.sumOfLocalMaxCosts();
+    }
+;
+
 states:
   state
 | states state
@@ -97,14 +107,13 @@ state:
   KW_STATE NUMBER lowlink scc markings
     {
     currentState=$2;
-	currentTaraState = getTaraState(currentState);
+	currentTaraState = lolaToTara.state(currentState);
 	if (currentState == 0) Tara::initialState = currentTaraState;
-	Tara::graph[currentTaraState]->inStack = false;
-	Tara::graph[currentTaraState]->final = Tara::net->getFinalCondition().isSatisfied(pnapi::Marking(currentMarking, Tara::net));
-    if (Tara::graph[currentTaraState]-> final) {
-        ++Tara::nrOfFinals;
-    }	
-        currentMarking.clear();
+	Tara::graph.setFinal(currentTaraState, finalCondition->isSatisfied(currentMarking));
+    for (unsigned int i = 0; i < markedPlaces.size(); ++i) {
+        currentMarking[markedPlaces[i]] = 0;
+    }
+    markedPlaces.clear();
 	
     }
     transitions
@@ -142,9 +151,11 @@ markingList:
 ;
 
 marking:
-  NAME COLON NUMBER
-  { currentMarking[Tara::net->findPlace($1)] = $3; free($1); }
+  PLACE COLON NUMBER
+  { currentMarking[$1] = $3; markedPlaces.push_back($1); }
   /* calculate current marking to find final states*/
+| NAME COLON NUMBER
+  /* a place of the partner */
 ;
 
 transitions:
@@ -162,35 +173,14 @@ transition:
   {
        if (currentState != $3) { // We do not need self loops
            
-           unsigned int targetTaraState = getTaraState($3);
-           
-           unsigned int oldTransition = Tara::graph[currentTaraState]->transitions.size();
+           unsigned int targetTaraState = lolaToTara.state($3);
            
-           for (unsigned int i = 0; i < Tara::graph[currentTaraState]->transitions.size(); ++i) {
-                if (Tara::graph[currentTaraState]->transitions[i].successor == targetTaraState) {
-                    oldTransition = i;
-
-                }
-            }
-             
-        	   pnapi::Transition *const transition = Tara::net->findTransition($1);
-           unsigned int trCosts = Tara::cost(transition);           
-                                   
-           if (oldTransition != Tara::graph[currentTaraState]->transitions.size() && Tara::graph[currentTaraState]->transitions[oldTransition].costs < trCosts) {
-                Tara::graph[currentTaraState]->transitions[oldTransition].costs = trCosts;
-
-           } else {
-               innerTransition cur= { transition, targetTaraState, trCosts };
-               Tara::graph[currentTaraState]->transitions.push_back(cur);
-               ++Tara::nrOfEdges;
-           }        
-	           
-           if (trCosts > Tara::graph[currentTaraState]->maxCosts) { 
-                Tara::sumOfLocalMaxCosts += trCosts - Tara::graph[currentTaraState]->maxCosts; 
-                Tara::graph[currentTaraState]->maxCosts = trCosts; 
-           }
+           // the lexer already resolved the name to a transition of the net
+           pnapi::Transition *const transition = $1;
+
+           // parallel edges are merged by the graph, keeping the highest costs
+           Tara::graph.addEdge(currentTaraState, targetTaraState, transition, Tara::cost(transition));
        }
-       free($1); //get rid of those strings
 
   }
 ;
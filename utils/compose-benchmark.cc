@@ -0,0 +1,141 @@
+/*****************************************************************************\
+ Tara-- <<-- Tara -->>
+
+ Copyright (c) <<-- 20XX Author1, Author2, ... -->>
+
+ Tara is free software: you can redistribute it and/or modify it under the
+ terms of the GNU Affero General Public License as published by the Free
+ Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ Tara is distributed in the hope that it will be useful, but WITHOUT ANY
+ WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public License for
+ more details.
+
+ You should have received a copy of the GNU Affero General Public License
+ along with Hello.  If not, see <http://www.gnu.org/licenses/>.
+\*****************************************************************************/
+
+/*
+ * Benchmark for PetriNet::compose with large partners.
+ *
+ * A most-permissive partner arrives in Tara as a state machine net, i.e.
+ * one place per state and one transition per edge, labeled with the
+ * interface of the service. This program builds such partners with a given
+ * number of states synthetically, composes each with a small service and
+ * reports the time of the composition.
+ *
+ * usage: compose-benchmark [states ...]   (default: 100000 1000000)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pnapi/pnapi.h>
+
+namespace {
+
+/// the number of interface labels in each direction
+const unsigned int LABELS = 8;
+
+/// a service reading LABELS inputs and writing LABELS outputs in a loop
+void buildService(pnapi::PetriNet& net) {
+    pnapi::Port& port = net.createPort("port");
+    pnapi::Place& idle = net.createPlace("idle", 1);
+    for (unsigned int i = 0; i < LABELS; ++i) {
+        std::stringstream in, out;
+        in << "in" << i;
+        out << "out" << i;
+        pnapi::Label& input = net.createInputLabel(in.str(), port);
+        pnapi::Label& output = net.createOutputLabel(out.str(), port);
+
+        pnapi::Place& busy = net.createPlace();
+        pnapi::Transition& receive = net.createTransition();
+        net.createArc(idle, receive);
+        net.createArc(receive, busy);
+        receive.addLabel(input);
+
+        pnapi::Transition& send = net.createTransition();
+        net.createArc(busy, send);
+        net.createArc(send, idle);
+        send.addLabel(output);
+    }
+    net.getFinalCondition().addProposition(idle == 1);
+}
+
+/// a state machine partner with the given number of states and two edges per state
+void buildPartner(pnapi::PetriNet& net, unsigned int states) {
+    pnapi::Port& port = net.createPort("port");
+    std::vector<pnapi::Label*> labels;
+    for (unsigned int i = 0; i < LABELS; ++i) {
+        std::stringstream in, out;
+        in << "in" << i;
+        out << "out" << i;
+        labels.push_back(&net.createOutputLabel(in.str(), port));
+        labels.push_back(&net.createInputLabel(out.str(), port));
+    }
+
+    std::vector<pnapi::Place*> place(states);
+    for (unsigned int s = 0; s < states; ++s) {
+        std::stringstream name;
+        name << "s" << s;
+        place[s] = &net.createPlace(name.str(), s == 0 ? 1 : 0);
+    }
+
+    srand(states);
+    for (unsigned int s = 0; s < states; ++s) {
+        const unsigned int successor[2] = { (s + 1) % states, rand() % states };
+        for (unsigned int e = 0; e < 2; ++e) {
+            pnapi::Transition& t = net.createTransition();
+            net.createArc(*place[s], t);
+            net.createArc(t, *place[successor[e]]);
+            t.addLabel(*labels[rand() % labels.size()]);
+        }
+    }
+    net.getFinalCondition().addProposition(*place[0] == 1);
+}
+
+double seconds(clock_t start) {
+    return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<unsigned int> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(atoi(argv[i]));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+    }
+
+    printf("%10s %10s %10s %10s %10s\n", "states", "places", "trans", "build[s]", "compose[s]");
+    for (unsigned int i = 0; i < sizes.size(); ++i) {
+        pnapi::PetriNet service;
+        buildService(service);
+
+        clock_t start = clock();
+        pnapi::PetriNet partner;
+        buildPartner(partner, sizes[i]);
+        const double build = seconds(start);
+
+        // this is what Tara does with the partner and the service
+        start = clock();
+        pnapi::PetriNet composition;
+        partner.compose(service, "mpp-", "", composition);
+        const double compose = seconds(start);
+
+        printf("%10u %10u %10u %10.2f %10.2f\n", sizes[i],
+               static_cast<unsigned int>(composition.getPlaces().size()),
+               static_cast<unsigned int>(composition.getTransitions().size()),
+               build, compose);
+    }
+
+    return EXIT_SUCCESS;
+}